@@ -0,0 +1,56 @@
+#include "concurrent_unordered_set.hpp"
+#include <iostream>
+#include <vector>
+#include <thread>
+using namespace std;
+
+mystl::concurrent_unordered_set<int> seen;
+
+// every worker inserts the same keys, each key must be inserted once
+void worker( int key_num, size_t &inserted )
+{
+    for( int i = 0; i < key_num; ++i )
+    {
+        if( seen.insert( i ) )
+        {
+            ++inserted;
+        }
+    }
+}
+
+int main()
+{
+    const int key_num = 100000;
+    const int thread_num = 8;
+
+    vector<size_t> inserted( thread_num, 0 );
+    vector<thread> workers;
+    for( int i = 0; i < thread_num; ++i )
+    {
+        workers.emplace_back( worker, key_num, ref( inserted[i] ) );
+    }
+    for( auto &t : workers )
+    {
+        t.join();
+    }
+
+    size_t total = 0;
+    for( auto num : inserted )
+    {
+        total += num;
+    }
+
+    size_t scanned = 0;
+    seen.for_each_shard( [&scanned]( const mystl::concurrent_unordered_set<int>::shard_type &shard ) {
+        scanned += shard.size();
+    } );
+
+    const size_t size = seen.size();
+    cout << "inserted: " << total << ", size: " << size << ", scanned: " << scanned 
+         << ", contains 42: " << boolalpha << seen.contains( 42 ) << endl;
+
+    const size_t expected = key_num;
+    const bool ok = total == expected && size == expected && scanned == expected && seen.contains( 42 );
+    cout << ( ok ? "passed" : "failed" ) << endl;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,101 @@
+#include "mmap_vector.hpp"
+#include <iostream>
+#include <cstdio>
+#include <cstring>
+#include <unistd.h>
+#include <sys/wait.h>
+using namespace std;
+
+struct point
+{
+    int x, y, z;
+};
+
+// a child pushes three elements, syncs and dies without running the destructor,
+// the file must reopen with those three elements
+template <typename T, typename Make>
+bool reopens_after_crash( const string &path, Make make )
+{
+    std::remove( path.c_str() );
+    const pid_t pid = ::fork();
+    if( pid == 0 )
+    {
+        mystl::mmap_vector<T> vec( path );
+        for( int i = 0; i < 3; ++i )
+        {
+            vec.push_back( make( i ) );
+        }
+        vec.sync();
+        vec.push_back( make( 3 ) );    // not synced
+        ::_exit( 0 );
+    }
+
+    int status = 0;
+    bool ok = pid > 0 && ::waitpid( pid, &status, 0 ) == pid && WIFEXITED( status );
+    if( ok )
+    {
+        mystl::mmap_vector<T> vec( path );
+        ok = vec.size() == 3 && vec.capacity() >= 3;
+        for( int i = 0; ok && i < 3; ++i )
+        {
+            const T expected = make( i );
+            ok = std::memcmp( &vec[i], &expected, sizeof( T ) ) == 0;
+        }
+        vec.push_back( make( 3 ) );
+        ok = ok && vec.size() == 4;
+    }
+    if( ok )
+    {
+        mystl::mmap_vector<T> vec( path );    // reopened after a clean close
+        ok = vec.size() == 4;
+    }
+    std::remove( path.c_str() );
+    return ok;
+}
+
+// a range insert which grows the file must keep the elements after the insert position
+int main()
+{
+    const string path = "mmap_vector_test.dat";
+    std::remove( path.c_str() );
+    bool ok = true;
+    {
+        mystl::mmap_vector<int> vec( path );
+        vec.reserve( 10 );
+        for( int i = 0; i < 10; ++i )
+        {
+            vec.push_back( i );
+        }
+
+        const int values[] = { 100, 101, 102 };
+        vec.insert( vec.begin() + 2, values, values + 3 );
+        const int expected[] = { 0, 1, 100, 101, 102, 2, 3, 4, 5, 6, 7, 8, 9 };
+        ok = ok && vec.size() == 13;
+        for( size_t i = 0; ok && i < 13; ++i )
+        {
+            ok = vec[i] == expected[i];
+        }
+
+        vec.insert( vec.begin() + 1, 2000, 7 );
+        ok = ok && vec.size() == 2013 && vec[0] == 0 && vec[1] == 7 && vec[2000] == 7 
+                && vec[2001] == 1 && vec[2002] == 100 && vec.back() == 9;
+
+        // the 2000 copies of 7 are skipped
+        cout << vec.size() << " elements: " << vec[0] << " 7 ... 7";
+        for( size_t i = 2001; i < vec.size(); ++i )
+        {
+            cout << " " << vec[i];
+        }
+        cout << endl;
+    }
+    std::remove( path.c_str() );
+
+    const bool ints = reopens_after_crash<int>( path, []( int i ) { return i * 10; } );
+    const bool points = reopens_after_crash<point>( path, []( int i ) { return point{ i, i + 1, i + 2 }; } );
+    cout << "reopened after a crash: int " << ( ints ? "ok" : "wrong" )
+         << ", 12-byte struct " << ( points ? "ok" : "wrong" ) << endl;
+    ok = ok && ints && points;
+
+    cout << ( ok ? "passed" : "failed" ) << endl;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,30 @@
+#include "memory.hpp"
+#include <iostream>
+#include <cstdint>
+#include <cstring>
+using namespace std;
+
+// an over-aligned request near the end of a block must get a fresh block
+int main()
+{
+    bool ok = true;
+    {
+        mystl::monotonic_arena arena( 100 );
+        auto first = static_cast<char *>( arena.allocate( 83, 1 ) );
+        std::memset( first, 1, 83 );
+
+        auto second = static_cast<char *>( arena.allocate( 8, 64 ) );
+        ok = ok && reinterpret_cast<std::uintptr_t>( second ) % 64 == 0;
+        ok = ok && ( second + 8 <= first || second >= first + 83 );
+        std::memset( second, 2, 8 );
+
+        for( int i = 0; ok && i < 83; ++i )
+        {
+            ok = first[i] == 1;
+        }
+        ok = ok && arena.bytes_allocated() == 91;
+    }
+
+    cout << ( ok ? "passed" : "failed" ) << endl;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,77 @@
+#include "algorithm.hpp"
+#include <iostream>
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <vector>
+#include <list>
+using namespace std;
+
+bool ok = true;
+
+void check( bool result, const char *what, size_t n )
+{
+    if( !result )
+    {
+        cout << what << " is wrong for " << n << " elements" << endl;
+        ok = false;
+    }
+}
+
+// the simd kernels must give the same results as the std algorithms, at every length and position
+template <typename T>
+void check_type( const T &special )
+{
+    for( size_t n = 0; n < 100; ++n )
+    {
+        vector<T> values( n );
+        for( size_t i = 0; i < n; ++i )
+        {
+            values[i] = static_cast<T>( i % 7 );
+        }
+        const T *first = values.data(), *last = first + n;
+
+        for( int v = 0; v < 9; ++v )
+        {
+            const T value = static_cast<T>( v );
+            check( mystl::find( first, last, value ) == std::find( first, last, value ), "find", n );
+            check( mystl::count( first, last, value ) == std::count( first, last, value ), "count", n );
+        }
+
+        for( size_t pos = 0; pos < n; ++pos )
+        {
+            auto other = values;
+            other[pos] = special;
+            T *begin2 = other.data();    // mixed const and non-const pointers
+            check( mystl::equal( first, last, begin2 ) == std::equal( first, last, begin2 ), "equal", n );
+            check( mystl::mismatch( first, last, begin2 ).first == std::mismatch( first, last, begin2 ).first, "mismatch", n );
+            check( mystl::lexicographical_compare( first, last, begin2, begin2 + n )
+                   == std::lexicographical_compare( first, last, begin2, begin2 + n ), "lexicographical_compare", n );
+            check( mystl::lexicographical_compare( begin2, begin2 + n, first, last )
+                   == std::lexicographical_compare( begin2, begin2 + n, first, last ), "lexicographical_compare", n );
+            check( mystl::lexicographical_compare( first, last, begin2, begin2 + pos )
+                   == std::lexicographical_compare( first, last, begin2, begin2 + pos ), "lexicographical_compare", n );
+        }
+    }
+}
+
+int main()
+{
+    check_type<signed char>( -1 );
+    check_type<std::uint16_t>( 60000 );
+    check_type<int>( -5 );
+    check_type<long long>( 1LL << 40 );
+    check_type<float>( std::numeric_limits<float>::quiet_NaN() );
+    check_type<double>( std::numeric_limits<double>::quiet_NaN() );
+    check_type<double>( -0.0 );
+
+    // ranges which the kernels don't handle: const elements and different element types
+    const vector<int> ints = { 1, 2, 3 };
+    const list<double> doubles = { 1, 2.5, 3 };
+    check( mystl::lexicographical_compare( ints.begin(), ints.end(), doubles.begin(), doubles.end() ), "lexicographical_compare", 3 );
+    check( !mystl::lexicographical_compare( doubles.begin(), doubles.end(), ints.begin(), ints.end() ), "lexicographical_compare", 3 );
+    check( mystl::lexicographical_compare( ints.begin(), ints.begin() + 1, doubles.begin(), doubles.end() ), "lexicographical_compare", 1 );
+
+    cout << ( ok ? "passed" : "failed" ) << endl;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,88 @@
+#include "small_vector.hpp"
+#include <iostream>
+#include <string>
+#include <type_traits>
+using namespace std;
+
+using small = mystl::small_vector<string, 4>;
+
+static_assert( !std::is_convertible<small *, mystl::vector<string, mystl::small_buffer_allocator<string, 4>> *>::value,
+               "a small_vector must not be usable as a vector" );
+
+small make( int n, const string &prefix )
+{
+    small vec;
+    for( int i = 0; i < n; ++i )
+    {
+        vec.push_back( prefix + to_string( i ) );
+    }
+    return vec;
+}
+
+bool same( const small &vec, int n, const string &prefix )
+{
+    return vec == make( n, prefix );
+}
+
+// swap, move and shrink_to_fit must never leave a small_vector pointing into another one's inline buffer
+int main()
+{
+    bool ok = true;
+
+    // inline with heap, both directions
+    {
+        auto a = make( 2, "a" ), b = make( 10, "b" );
+        a.swap( b );
+        ok = ok && same( a, 10, "b" ) && same( b, 2, "a" ) && b.is_inline() && !a.is_inline();
+        swap( a, b );
+        ok = ok && same( a, 2, "a" ) && same( b, 10, "b" ) && a.is_inline();
+    }
+
+    // heap with heap, inline with inline
+    {
+        auto a = make( 6, "a" ), b = make( 9, "b" );
+        a.swap( b );
+        ok = ok && same( a, 9, "b" ) && same( b, 6, "a" );
+
+        auto c = make( 1, "c" ), d = make( 3, "d" );
+        c.swap( d );
+        ok = ok && same( c, 3, "d" ) && same( d, 1, "c" ) && c.is_inline() && d.is_inline();
+    }
+
+    // the moved-from small_vector keeps using its own inline buffer
+    {
+        auto a = make( 3, "a" );
+        small b( std::move( a ) );
+        a.push_back( "x" );
+        ok = ok && same( b, 3, "a" ) && b.is_inline() && a.is_inline() && a.size() == 1;
+
+        auto c = make( 8, "c" );
+        small d( std::move( c ) );
+        c.push_back( "y" );
+        ok = ok && same( d, 8, "c" ) && c.is_inline() && c.size() == 1;
+
+        d = std::move( b );
+        ok = ok && same( d, 3, "a" ) && d.is_inline() && b.empty();
+        b = make( 7, "b" );
+        ok = ok && same( b, 7, "b" ) && !b.is_inline();
+    }
+
+    // shrink_to_fit goes back to the inline buffer when the elements fit
+    {
+        auto a = make( 12, "a" );
+        a.resize( 3 );
+        a.shrink_to_fit();
+        ok = ok && same( a, 3, "a" ) && a.is_inline();
+
+        auto b = make( 12, "b" );
+        b.resize( 6 );
+        b.shrink_to_fit();
+        ok = ok && same( b, 6, "b" ) && !b.is_inline() && b.capacity() == 6;
+
+        a.swap( b );
+        ok = ok && same( a, 6, "b" ) && same( b, 3, "a" ) && b.is_inline();
+    }
+
+    cout << ( ok ? "passed" : "failed" ) << endl;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,111 @@
+#include "vector.hpp"
+#include <iostream>
+#include <string>
+#include <chrono>
+#include <cstdlib>
+using namespace std;
+
+struct Record
+{
+    long id;
+    long timestamp;
+    double value;
+    double weight;
+};
+
+template <typename Vector>
+void benchmark( const string &name, size_t elem_num )
+{
+    size_t capacity = 0;
+    auto start = chrono::steady_clock::now();
+    {
+        Vector vec;
+        for( size_t i = 0; i < elem_num; ++i )
+        {
+            vec.push_back( typename Vector::value_type() );
+        }
+        capacity = vec.capacity();
+    }
+    auto stop = chrono::steady_clock::now();
+
+    cout << name << ": "
+         << chrono::duration_cast<chrono::milliseconds>( stop - start ).count()
+         << " ms, unused capacity " 
+         << ( capacity - elem_num ) * 100.0 / elem_num << "%" << endl;
+}
+
+/**
+   pushes elem_num elements into each of count small vectors in turn,
+   which shows how much memory the growth policy leaves unused
+**/
+template <typename Vector>
+void benchmark_many( const string &name, size_t count, size_t elem_num )
+{
+    size_t capacity = 0;
+    auto start = chrono::steady_clock::now();
+    {
+        mystl::vector<Vector> vecs( count );
+        for( size_t i = 0; i < elem_num; ++i )
+        {
+            for( auto &vec : vecs )
+            {
+                vec.push_back( typename Vector::value_type() );
+            }
+        }
+        for( const auto &vec : vecs )
+        {
+            capacity += vec.capacity();
+        }
+    }
+    auto stop = chrono::steady_clock::now();
+
+    cout << name << ": "
+         << chrono::duration_cast<chrono::milliseconds>( stop - start ).count()
+         << " ms, unused capacity " 
+         << ( capacity - count * elem_num ) * 100.0 / ( count * elem_num ) << "%" << endl;
+}
+
+/**
+   compares the copy-based growth of std::allocator
+   with the in-place growth of malloc_allocator (realloc) and mmap_allocator (mremap),
+   then compares the growth policies
+
+   usage: VectorGrowthBenchmark [element number]
+**/
+int main( int argc, char *argv[] )
+{
+    size_t elem_num = argc > 1 ? strtoull( argv[1], nullptr, 10 ) : 50000000;
+    cout << "push_back " << elem_num << " elements" << endl;
+
+    benchmark<mystl::vector<int>>( "vector<int>, std::allocator        ", elem_num );
+    benchmark<mystl::vector<int, mystl::malloc_allocator<int>>>( "vector<int>, malloc_allocator      ", elem_num );
+#if defined(__linux__)
+    benchmark<mystl::vector<int, mystl::mmap_allocator<int>>>( "vector<int>, mmap_allocator        ", elem_num );
+#endif
+
+    benchmark<mystl::vector<Record>>( "vector<Record>, std::allocator     ", elem_num );
+    benchmark<mystl::vector<Record, mystl::malloc_allocator<Record>>>( "vector<Record>, malloc_allocator   ", elem_num );
+#if defined(__linux__)
+    benchmark<mystl::vector<Record, mystl::mmap_allocator<Record>>>( "vector<Record>, mmap_allocator     ", elem_num );
+#endif
+
+    cout << endl << "growth policies, one big vector" << endl;
+    benchmark<mystl::vector<Record, std::allocator<Record>, mystl::double_growth>>( 
+        "double_growth                      ", elem_num );
+    benchmark<mystl::vector<Record, std::allocator<Record>, mystl::one_and_a_half_growth>>( 
+        "one_and_a_half_growth              ", elem_num );
+    benchmark<mystl::vector<Record, std::allocator<Record>, mystl::size_class_growth<>>>( 
+        "size_class_growth                  ", elem_num );
+
+    const size_t small_size = 37;
+    const size_t count = elem_num / small_size;
+    cout << endl << "growth policies, " << count << " vectors of " << small_size << " elements" << endl;
+    benchmark_many<mystl::vector<Record, std::allocator<Record>, mystl::double_growth>>( 
+        "double_growth                      ", count, small_size );
+    benchmark_many<mystl::vector<Record, std::allocator<Record>, mystl::one_and_a_half_growth>>( 
+        "one_and_a_half_growth              ", count, small_size );
+    benchmark_many<mystl::vector<Record, std::allocator<Record>, mystl::size_class_growth<>>>( 
+        "size_class_growth                  ", count, small_size );
+
+    return 0;
+}
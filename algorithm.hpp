@@ -6,9 +6,36 @@
 #include <algorithm>
 #include <random>
 #include <iterator>
+#include <type_traits>
+#include "simd.hpp"
 
 namespace mystl {
 
+// true if [beg, end) of Iterator is a contiguous array of T which the simd kernels can search for a T
+template <typename Iterator, typename T>
+struct use_simd_search : std::false_type
+{
+};
+
+template <typename U, typename T>
+struct use_simd_search<U *, T> 
+    : std::integral_constant<bool, std::is_same<typename std::remove_cv<U>::type, T>::value &&
+                                   simd::is_vectorizable<T>::value>
+{
+};
+
+// true if two ranges of Iterator1 and Iterator2 are contiguous arrays which the simd kernels can compare
+template <typename Iterator1, typename Iterator2>
+struct use_simd_compare : std::false_type
+{
+};
+
+template <typename U, typename V>
+struct use_simd_compare<U *, V *> 
+    : use_simd_search<U *, typename std::remove_cv<V>::type>
+{
+};
+
 template<typename InputIterator>
 inline typename std::iterator_traits<InputIterator>::difference_type
 distance( InputIterator first, InputIterator last ) 
@@ -48,7 +75,7 @@ inline OutputIterator copy( InputIterator beg, InputIterator end, OutputIterator
 }
 
 template <typename InputIterator, typename T>
-InputIterator find( InputIterator beg, InputIterator end, const T &value ) 
+InputIterator find( InputIterator beg, InputIterator end, const T &value, std::false_type ) 
 {
     for( ; beg != end && *beg != value; ++beg )
     {        
@@ -56,6 +83,18 @@ InputIterator find( InputIterator beg, InputIterator end, const T &value )
     return beg;
 }
 
+template <typename Pointer, typename T>
+Pointer find( Pointer beg, Pointer end, const T &value, std::true_type ) 
+{
+    return beg + ( simd::find<T>( beg, end, value ) - beg );
+}
+
+template <typename InputIterator, typename T>
+InputIterator find( InputIterator beg, InputIterator end, const T &value ) 
+{
+    return mystl::find( beg, end, value, typename use_simd_search<InputIterator, T>::type() );
+}
+
 template <typename InputIterator, typename UnaryPredicate>
 InputIterator find_if( InputIterator beg, InputIterator end, UnaryPredicate predicate ) 
 {
@@ -154,7 +193,7 @@ minmax_element( ForwardIterator beg, ForwardIterator end )
 
 
 template <typename InputIterator1, typename InputIterator2>
-bool equal( InputIterator1 beg1, InputIterator1 end1, InputIterator2 beg2 ) 
+bool equal( InputIterator1 beg1, InputIterator1 end1, InputIterator2 beg2, std::false_type ) 
 {
     while( beg1 != end1 ) 
     {
@@ -166,6 +205,19 @@ bool equal( InputIterator1 beg1, InputIterator1 end1, InputIterator2 beg2 )
     return true;
 }
 
+template <typename Pointer1, typename Pointer2>
+bool equal( Pointer1 beg1, Pointer1 end1, Pointer2 beg2, std::true_type ) 
+{
+    using value_type = typename std::remove_cv<typename std::remove_pointer<Pointer1>::type>::type;
+    return simd::mismatch<value_type>( beg1, end1, beg2 ) == end1;
+}
+
+template <typename InputIterator1, typename InputIterator2>
+bool equal( InputIterator1 beg1, InputIterator1 end1, InputIterator2 beg2 ) 
+{
+    return mystl::equal( beg1, end1, beg2, typename use_simd_compare<InputIterator1, InputIterator2>::type() );
+}
+
 template <typename InputIterator1, typename InputIterator2, typename BinaryPredicate>
 bool equal( InputIterator1 beg1, InputIterator1 end1, InputIterator2 beg2, BinaryPredicate predicate ) 
 {
@@ -180,7 +232,7 @@ bool equal( InputIterator1 beg1, InputIterator1 end1, InputIterator2 beg2, Binar
 }
 
 template <typename InputIterator, typename T>
-auto count( InputIterator beg, InputIterator end, const T &value ) -> decltype( beg - beg )
+auto count( InputIterator beg, InputIterator end, const T &value, std::false_type ) -> decltype( beg - beg )
 {
     auto num = beg - beg;
     while( beg != end ) 
@@ -193,6 +245,18 @@ auto count( InputIterator beg, InputIterator end, const T &value ) -> decltype(
     return num;
 } 
 
+template <typename Pointer, typename T>
+auto count( Pointer beg, Pointer end, const T &value, std::true_type ) -> decltype( beg - beg )
+{
+    return simd::count<T>( beg, end, value );
+} 
+
+template <typename InputIterator, typename T>
+auto count( InputIterator beg, InputIterator end, const T &value ) -> decltype( beg - beg )
+{
+    return mystl::count( beg, end, value, typename use_simd_search<InputIterator, T>::type() );
+} 
+
 
 template <typename InputIterator, typename UnaryPredicate>
 auto count_if( InputIterator beg, InputIterator end, UnaryPredicate predicate ) -> decltype( beg - beg )
@@ -279,7 +343,7 @@ bool is_permutation( ForwardIterator1 beg1, ForwardIterator1 end1, ForwardIterat
 
 template <typename InputIterator1, typename InputIterator2>
 std::pair<InputIterator1, InputIterator2>
-mismatch( InputIterator1 beg1, InputIterator1 end1, InputIterator2 beg2 ) 
+mismatch( InputIterator1 beg1, InputIterator1 end1, InputIterator2 beg2, std::false_type ) 
 {
     for( ; beg1 != end1; ++beg1, ++beg2 ) 
     {
@@ -291,6 +355,22 @@ mismatch( InputIterator1 beg1, InputIterator1 end1, InputIterator2 beg2 )
     return { beg1, beg2 };
 }
 
+template <typename Pointer1, typename Pointer2>
+std::pair<Pointer1, Pointer2>
+mismatch( Pointer1 beg1, Pointer1 end1, Pointer2 beg2, std::true_type ) 
+{
+    using value_type = typename std::remove_cv<typename std::remove_pointer<Pointer1>::type>::type;
+    auto n = simd::mismatch<value_type>( beg1, end1, beg2 ) - beg1;
+    return { beg1 + n, beg2 + n };
+}
+
+template <typename InputIterator1, typename InputIterator2>
+std::pair<InputIterator1, InputIterator2>
+mismatch( InputIterator1 beg1, InputIterator1 end1, InputIterator2 beg2 ) 
+{
+    return mystl::mismatch( beg1, end1, beg2, typename use_simd_compare<InputIterator1, InputIterator2>::type() );
+}
+
 template <typename InputIterator1, typename InputIterator2, typename BinaryPredicate>
 std::pair<InputIterator1, InputIterator2>
 mismatch( InputIterator1 beg1, InputIterator1 end1, InputIterator2 beg2, BinaryPredicate predicate ) 
@@ -302,7 +382,80 @@ mismatch( InputIterator1 beg1, InputIterator1 end1, InputIterator2 beg2, BinaryP
             break;
         }
     }
-    return { beg1, beg2 };   
+    return { beg1, beg2 };
+}
+
+template <typename InputIterator1, typename InputIterator2, typename Compare>
+bool lexicographical_compare( InputIterator1 beg1, InputIterator1 end1,
+                              InputIterator2 beg2, InputIterator2 end2, Compare comp )
+{
+    for( ; beg1 != end1 && beg2 != end2; ++beg1, ++beg2 )
+    {
+        if( comp( *beg1, *beg2 ) )
+        {
+            return true;
+        }
+        if( comp( *beg2, *beg1 ) )
+        {
+            return false;
+        }
+    }
+    return beg1 == end1 && beg2 != end2;
+}
+
+template <typename InputIterator1, typename InputIterator2>
+bool lexicographical_compare( InputIterator1 beg1, InputIterator1 end1,
+                              InputIterator2 beg2, InputIterator2 end2, std::false_type )
+{
+    for( ; beg1 != end1 && beg2 != end2; ++beg1, ++beg2 )
+    {
+        if( *beg1 < *beg2 )
+        {
+            return true;
+        }
+        if( *beg2 < *beg1 )
+        {
+            return false;
+        }
+    }
+    return beg1 == end1 && beg2 != end2;
+}
+
+/**
+   the simd kernels skip the equal prefix, then the first different elements decide.
+   unordered elements ( a NaN ) are neither less nor greater, so the comparison goes on after them
+**/
+template <typename Pointer1, typename Pointer2>
+bool lexicographical_compare( Pointer1 beg1, Pointer1 end1,
+                              Pointer2 beg2, Pointer2 end2, std::true_type )
+{
+    const auto last1 = beg1 + std::min( end1 - beg1, end2 - beg2 );
+    for( ; ; ++beg1, ++beg2 )
+    {
+        auto pos = mystl::mismatch( beg1, last1, beg2, std::true_type() );
+        beg1 = pos.first;
+        beg2 = pos.second;
+        if( beg1 == last1 )
+        {
+            return last1 == end1 && beg2 != end2;
+        }
+        if( *beg1 < *beg2 )
+        {
+            return true;
+        }
+        if( *beg2 < *beg1 )
+        {
+            return false;
+        }
+    }
+}
+
+template <typename InputIterator1, typename InputIterator2>
+bool lexicographical_compare( InputIterator1 beg1, InputIterator1 end1,
+                              InputIterator2 beg2, InputIterator2 end2 )
+{
+    return mystl::lexicographical_compare( beg1, end1, beg2, end2,
+                                           typename use_simd_compare<InputIterator1, InputIterator2>::type() );
 }
 
 template <typename ForwardIterator, typename T>
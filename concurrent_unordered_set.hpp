@@ -0,0 +1,255 @@
+/***
+    并发散列表
+        1. 元素按散列值分布到多个分片中，每个分片是一个 unordered_set，由各自的互斥锁保护
+        2. 散列值在加锁前计算，分片内的查找和插入直接使用这个散列值
+        3. 不同分片上的操作互不阻塞，分片数默认为硬件线程数的 4 倍
+        4. 不提供迭代器，通过 for_each_shard 在加锁的情况下遍历每个分片
+
+    版本 1.0
+ ***/
+
+#ifndef _CONCURRENT_UNORDERED_SET_H_
+#define _CONCURRENT_UNORDERED_SET_H_
+
+#include "unordered_set.hpp"
+#include <mutex>
+#include <thread>
+#include <limits>
+#include <memory>
+#include <cstddef>
+#include <utility>
+#include <functional>
+
+namespace mystl {
+
+/**
+   a hash set which many threads may use at the same time. the elements are partitioned
+   into shards by their hash codes, each shard is an unordered_set with its own mutex,
+   so threads working on different shards never wait for each other
+**/
+template <typename T, typename Hash = std::hash<T>, typename Equal = std::equal_to<T>>
+class concurrent_unordered_set
+{
+public:
+    using key_type        = T;
+    using value_type      = T;
+    using hasher          = Hash;
+    using key_equal       = Equal;
+    using size_type       = std::size_t;
+    using shard_type      = unordered_set<T, Hash, Equal>;
+    using mutex_type      = std::mutex;
+
+private:
+    static const std::size_t CACHE_LINE_SIZE = 64;
+
+    // each shard starts a cache line, so the mutexes of neighbouring shards never share one
+    struct alignas( CACHE_LINE_SIZE ) shard
+    {
+        mutable mutex_type mutex_;
+        shard_type         set_;
+    };
+
+    hasher                    hash_;
+    size_type                 shard_mask_;
+    std::unique_ptr<char[]>   shard_memory_;    // operator new doesn't promise the alignment of shard before C++17
+    shard                    *shards_;          // aligned by hand inside shard_memory_
+
+public:
+    /**
+       shard_num is rounded up to a power of two,
+       more shards means less contention but a higher cost for size() and for_each_shard()
+    **/
+    explicit concurrent_unordered_set( size_type shard_num = default_shard_count(),
+                                       const hasher &hash = hasher(), const key_equal &equal = key_equal() )
+        : hash_( hash ),
+          shard_mask_( round_up( shard_num ) - 1 ),
+          shard_memory_( new char[shard_count() * sizeof( shard ) + CACHE_LINE_SIZE] )
+    {
+        void *memory = shard_memory_.get();
+        std::size_t space = shard_count() * sizeof( shard ) + CACHE_LINE_SIZE;
+        shards_ = static_cast<shard *>( std::align( CACHE_LINE_SIZE, shard_count() * sizeof( shard ), memory, space ) );
+
+        size_type built = 0;
+        try
+        {
+            for( ; built <= shard_mask_; ++built )
+            {
+                ::new ( static_cast<void *>( shards_ + built ) ) shard;
+            }
+            for( size_type i = 0; i <= shard_mask_; ++i )
+            {
+                shard_type( 0, hash, equal ).swap( shards_[i].set_ );
+            }
+        }
+        catch( ... )
+        {
+            destroy_shards( built );
+            throw;
+        }
+    }
+
+    concurrent_unordered_set( const concurrent_unordered_set & ) = delete;
+    concurrent_unordered_set &operator=( const concurrent_unordered_set & ) = delete;
+
+    ~concurrent_unordered_set()
+    {
+        destroy_shards( shard_count() );
+    }
+
+    size_type shard_count() const noexcept
+    {
+        return shard_mask_ + 1;
+    }
+
+    // the shards are counted one after another, so the result is exact only if no other thread modifies the set
+    size_type size() const
+    {
+        size_type num = 0;
+        for( size_type i = 0; i <= shard_mask_; ++i )
+        {
+            std::lock_guard<mutex_type> lock( shards_[i].mutex_ );
+            num += shards_[i].set_.size();
+        }
+        return num;
+    }
+
+    bool empty() const
+    {
+        return size() == 0;
+    }
+
+    // makes room for elem_num elements, assuming the elements spread evenly over the shards
+    void reserve( size_type elem_num )
+    {
+        const size_type per_shard = elem_num / shard_count() + 1;
+        for( size_type i = 0; i <= shard_mask_; ++i )
+        {
+            std::lock_guard<mutex_type> lock( shards_[i].mutex_ );
+            shards_[i].set_.reserve( per_shard );
+        }
+    }
+
+    void clear()
+    {
+        for( size_type i = 0; i <= shard_mask_; ++i )
+        {
+            std::lock_guard<mutex_type> lock( shards_[i].mutex_ );
+            shards_[i].set_.clear();
+        }
+    }
+
+    // returns true if value was inserted, false if it was already in the set
+    bool insert( const value_type &value )
+    {
+        return insert_hashed( hash_( value ), value );
+    }
+
+    bool insert( value_type &&value )
+    {
+        const size_type hash = hash_( value );
+        return insert_hashed( hash, std::move( value ) );
+    }
+
+    template <typename... Args>
+    bool emplace( Args&&... args )
+    {
+        return insert( value_type( std::forward<Args>( args )... ) );
+    }
+
+    // returns the number of elements erased, 0 or 1
+    size_type erase( const value_type &value )
+    {
+        const size_type hash = hash_( value );
+        auto &target = shard_of( hash );
+        std::lock_guard<mutex_type> lock( target.mutex_ );
+        auto iter = target.set_.find_with( hash, value );
+        if( iter == target.set_.end() )
+        {
+            return 0;
+        }
+        target.set_.erase( iter );
+        return 1;
+    }
+
+    bool contains( const value_type &value ) const
+    {
+        const size_type hash = hash_( value );
+        auto &target = shard_of( hash );
+        std::lock_guard<mutex_type> lock( target.mutex_ );
+        return target.set_.find_with( hash, value ) != target.set_.end();
+    }
+
+    size_type count( const value_type &value ) const
+    {
+        return contains( value ) ? 1 : 0;
+    }
+
+    /**
+       calls func( const shard_type & ) for every shard while holding the lock of that shard,
+       so func sees each shard in a consistent state, but the shards are visited one after another
+       and other threads may modify the shards not yet visited. func must not call back into this set
+    **/
+    template <typename Function>
+    void for_each_shard( Function func ) const
+    {
+        for( size_type i = 0; i <= shard_mask_; ++i )
+        {
+            std::lock_guard<mutex_type> lock( shards_[i].mutex_ );
+            func( static_cast<const shard_type &>( shards_[i].set_ ) );
+        }
+    }
+
+private:
+    template <typename Value>
+    bool insert_hashed( size_type hash, Value &&value )
+    {
+        auto &target = shard_of( hash );
+        std::lock_guard<mutex_type> lock( target.mutex_ );
+        if( target.set_.find_with( hash, value ) != target.set_.end() )
+        {
+            return false;
+        }
+        target.set_.insert_new( hash, std::forward<Value>( value ) );
+        return true;
+    }
+
+    /**
+       the shard is picked by the high bits of the mixed hash code,
+       while the buckets in a shard are picked by the hash code modulo a prime,
+       so the elements of one shard still spread over all its buckets
+    **/
+    shard &shard_of( size_type hash ) const noexcept
+    {
+        return shards_[( mix_hash( hash ) >> ( std::numeric_limits<size_type>::digits / 2 ) ) & shard_mask_];
+    }
+
+    void destroy_shards( size_type num ) noexcept
+    {
+        for( size_type i = 0; i < num; ++i )
+        {
+            shards_[i].~shard();
+        }
+    }
+
+    static size_type round_up( size_type shard_num ) noexcept
+    {
+        size_type num = 1;
+        while( num < shard_num )
+        {
+            num <<= 1;
+        }
+        return num;
+    }
+
+    static size_type default_shard_count()
+    {
+        const size_type threads = std::thread::hardware_concurrency();
+        return threads == 0 ? 16 : threads * 4;
+    }
+};
+
+
+};    // namespace mystl
+
+
+#endif /* _CONCURRENT_UNORDERED_SET_H_ */
@@ -0,0 +1,829 @@
+/***
+    开放寻址散列表
+        1. 元素直接存放在一个连续的数组中，每个元素不需要单独分配节点
+        2. 每个位置有一个控制字节，保存散列值的低 7 位，查找时用 SIMD 一次比较 16 个控制字节
+        3. 容量为 2 的幂，线性探测，删除元素时向前移动后面的元素，不留下墓碑
+           每个位置记录元素到其初始位置的距离，删除时不需要重新计算散列值
+        4. 接口与 unordered_set 相同，但没有桶接口
+        5. 引入异常，对于不合法的操作会抛出异常
+
+    版本 1.0
+ ***/
+
+#ifndef _FLAT_HASH_SET_H_
+#define _FLAT_HASH_SET_H_
+
+#include "algorithm.hpp"
+#include "iterator.hpp"
+#include "simd.hpp"
+#include "hash_policy.hpp"
+#include <string>
+#include <memory>
+#include <limits>
+#include <cstdint>
+#include <cstddef>
+#include <utility>
+#include <iterator>
+#include <iostream>
+#include <exception>
+#include <functional>
+#include <type_traits>
+#include <initializer_list>
+
+namespace mystl {
+
+class flat_hash_set_exception : public std::exception
+{
+public:
+    explicit flat_hash_set_exception( const std::string &message )
+        : message_( message )
+    {
+    }
+
+    virtual const char * what() const noexcept override
+    {
+        return message_.c_str();
+    }
+
+private:
+    std::string message_;
+};
+
+/**
+   the control bytes of GROUP_WIDTH consecutive slots,
+   bit i of a returned mask stands for the i-th slot of the group
+**/
+class flat_hash_group
+{
+public:
+    using ctrl_type = signed char;
+
+    static const std::size_t GROUP_WIDTH = 16;
+    static const ctrl_type   EMPTY = -128;
+
+#if defined( MYSTL_SIMD_X86 )
+    explicit flat_hash_group( const ctrl_type *ctrl ) noexcept
+        : ctrl_( _mm_loadu_si128( reinterpret_cast<const __m128i *>( ctrl ) ) )
+    {
+    }
+
+    // slots whose control byte equals h2
+    unsigned match( ctrl_type h2 ) const noexcept
+    {
+        return _mm_movemask_epi8( _mm_cmpeq_epi8( _mm_set1_epi8( h2 ), ctrl_ ) );
+    }
+
+    // EMPTY is the only negative control byte
+    unsigned match_empty() const noexcept
+    {
+        return _mm_movemask_epi8( ctrl_ );
+    }
+
+private:
+    __m128i ctrl_;
+#else
+    explicit flat_hash_group( const ctrl_type *ctrl ) noexcept
+        : ctrl_( ctrl )
+    {
+    }
+
+    unsigned match( ctrl_type h2 ) const noexcept
+    {
+        unsigned mask = 0;
+        for( std::size_t i = 0; i < GROUP_WIDTH; ++i )
+        {
+            mask |= static_cast<unsigned>( ctrl_[i] == h2 ) << i;
+        }
+        return mask;
+    }
+
+    unsigned match_empty() const noexcept
+    {
+        return match( EMPTY );
+    }
+
+private:
+    const ctrl_type *ctrl_;
+#endif
+};
+
+/**
+   flat_hash_set keeps the elements in one array of slots, a parallel array holds a control byte
+   for each slot, which is either EMPTY or the low 7 bits of the element's hash.
+   a lookup starts at the slot given by the other bits of the hash and compares 16 control bytes
+   at once, so the elements are only touched when their control bytes match.
+   the first GROUP_WIDTH control bytes are mirrored after the last one,
+   thus a group starting near the end of the array wraps around without any check.
+
+   the probing is linear, so an element is never separated from its home slot by an empty slot.
+   erase() keeps this by shifting the following elements of the run backward,
+   there are no tombstones and the lookups never slow down after many erasures.
+   each slot also records how far its element is from its home slot, so erase() never calls Hash.
+
+   note: inserting an element, swap and move invalidate all iterators, erase( position ) returns
+   a valid iterator. the elements are moved with their move constructor, which shouldn't throw
+**/
+template <typename T, typename Hash = std::hash<T>, typename Equal = std::equal_to<T>>
+class flat_hash_set
+{
+private:
+    using ctrl_type             = flat_hash_group::ctrl_type;
+    using alloc_traits          = std::allocator_traits<std::allocator<T>>;
+
+    static const std::size_t GROUP_WIDTH = flat_hash_group::GROUP_WIDTH;
+    static const ctrl_type   EMPTY = flat_hash_group::EMPTY;
+    static const std::size_t MIN_CAPACITY = 16;
+
+    // the distance of an element from its home slot, which is less than the capacity
+    using distance_type         = std::uint32_t;
+
+public:
+    using key_type              = T;
+    using value_type            = T;
+    using hasher                = Hash;
+    using key_equal             = Equal;
+    using pointer               = T *;
+    using const_pointer         = const T*;
+    using reference             = T&;
+    using const_reference       = const T&;
+    using size_type             = std::size_t;
+    using difference_type       = std::ptrdiff_t;
+
+    /**
+       the iteration starts after the empty slot start_ and wraps around the end of the array,
+       a run of elements never contains an empty slot, so no run is split by the iteration
+    **/
+    class const_iterator
+    {
+        friend class flat_hash_set;
+    public:
+        using value_type        = T;
+        using pointer           = const T*;
+        using reference         = const T&;
+        using difference_type   = std::ptrdiff_t;
+        using iterator_category = std::forward_iterator_tag;
+
+        const_iterator()
+            : set_( nullptr ), index_( 0 ), remaining_( 0 )
+        {
+        }
+
+        reference operator*() const
+        {
+            return set_->slots_[index_];
+        }
+
+        pointer operator->() const
+        {
+            return &( operator*() );
+        }
+
+        const_iterator &operator++() noexcept
+        {
+            while( remaining_ != 0 )
+            {
+                index_ = ( index_ + 1 ) & ( set_->capacity_ - 1 );
+                --remaining_;
+                if( set_->ctrl_[index_] != EMPTY )
+                {
+                    return *this;
+                }
+            }
+            index_ = set_->capacity_;
+            return *this;
+        }
+
+        const_iterator operator++(int) noexcept
+        {
+            auto tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        bool operator==( const const_iterator &other ) const noexcept
+        {
+            return index_ == other.index_;
+        }
+
+        bool operator!=( const const_iterator &other ) const noexcept
+        {
+            return !( *this == other );
+        }
+
+    protected:
+        const_iterator( const flat_hash_set *set, size_type index, size_type remaining )
+            : set_( set ), index_( index ), remaining_( remaining )
+        {
+        }
+
+    private:
+        const flat_hash_set *set_;
+        size_type            index_;            // capacity_ for the off-the-end iterator
+        size_type            remaining_;        // the number of slots after index_
+    };
+
+    /**
+       iterator is same as const_iterator
+       because we don't want user modify element by using iterator
+    **/
+    using iterator = const_iterator;
+
+private:
+    hasher         hash_;                           // hash function
+    key_equal      equal_;                          // for test value' equality
+    ctrl_type     *ctrl_ = nullptr;                 // capacity_ + GROUP_WIDTH control bytes
+    T             *slots_ = nullptr;                // capacity_ slots
+    distance_type *dist_ = nullptr;                 // capacity_ distances from the home slots
+    size_type      capacity_ = 0;                   // zero or a power of two, at least MIN_CAPACITY
+    size_type      size_ = 0;                       // elements number
+    size_type      start_ = 0;                      // an empty slot, the iteration starts after it
+
+public:
+    flat_hash_set() = default;
+
+    explicit flat_hash_set( size_type elem_num, const hasher &hash = hasher(), const key_equal &equal = key_equal() )
+        : hash_( hash ),
+          equal_( equal )
+    {
+        reserve( elem_num );
+    }
+
+    template<typename InputIterator, typename = mystl::RequireInputIterator<InputIterator>>
+    flat_hash_set( InputIterator first, InputIterator last, size_type elem_num = 0,
+                   const hasher &hash = hasher(), const key_equal &equal = key_equal() )
+        : flat_hash_set( elem_num, hash, equal )
+    {
+        insert( first, last );
+    }
+
+    flat_hash_set( std::initializer_list<value_type> lst, size_type elem_num = 0,
+                   const hasher &hash = hasher(), const key_equal &equal = key_equal() )
+        : flat_hash_set( lst.begin(), lst.end(), elem_num, hash, equal )
+    {
+    }
+
+    // the copy has the same layout as other, no element is rehashed
+    flat_hash_set( const flat_hash_set &other )
+        : hash_( other.hash_ ),
+          equal_( other.equal_ )
+    {
+        if( other.size_ == 0 )
+        {
+            return;
+        }
+        allocate_table( other.capacity_ );
+        try
+        {
+            for( size_type i = 0; i < capacity_; ++i )
+            {
+                if( other.ctrl_[i] != EMPTY )
+                {
+                    ::new ( static_cast<void *>( slots_ + i ) ) T( other.slots_[i] );
+                    set_ctrl( i, other.ctrl_[i] );
+                    dist_[i] = other.dist_[i];
+                }
+            }
+        }
+        catch( ... )
+        {
+            destroy_table();
+            throw;
+        }
+        size_ = other.size_;
+        start_ = other.start_;
+    }
+
+    flat_hash_set( flat_hash_set &&other ) noexcept
+    {
+        swap( other );
+    }
+
+    ~flat_hash_set()
+    {
+        destroy_table();
+    }
+
+    flat_hash_set &operator=( const flat_hash_set &other )
+    {
+        auto copy = other;
+        swap( copy );
+        return *this;
+    }
+
+    flat_hash_set &operator=( flat_hash_set &&other ) noexcept
+    {
+        if( this != &other )
+        {
+            destroy_table();
+            swap( other );
+        }
+        return *this;
+    }
+
+    flat_hash_set &operator=( std::initializer_list<value_type> lst )
+    {
+        clear();
+        insert( lst.begin(), lst.end() );
+        return *this;
+    }
+
+    void swap( flat_hash_set &other ) noexcept
+    {
+        using std::swap;
+        swap( hash_, other.hash_ );
+        swap( equal_, other.equal_ );
+        swap( ctrl_, other.ctrl_ );
+        swap( slots_, other.slots_ );
+        swap( dist_, other.dist_ );
+        swap( capacity_, other.capacity_ );
+        swap( size_, other.size_ );
+        swap( start_, other.start_ );
+    }
+
+    // the number of slots
+    size_type capacity() const noexcept
+    {
+        return capacity_;
+    }
+
+    /**
+       changes the capacity to the smallest power of two which is not less than slot_num
+       and can hold size() elements, all elements are moved into the new slots
+    **/
+    void rehash( size_type slot_num )
+    {
+        size_type new_capacity = MIN_CAPACITY;
+        while( new_capacity < slot_num || max_elements( new_capacity ) < size_ )
+        {
+            if( new_capacity == max_capacity() )
+            {
+                throw flat_hash_set_exception( "flat_hash_set::rehash(): too many slots!" );
+            }
+            new_capacity *= 2;
+        }
+        if( new_capacity != capacity_ )
+        {
+            resize_table( new_capacity );
+        }
+    }
+
+    // makes room for elem_num elements, so that inserting them won't move any element
+    void reserve( size_type elem_num )
+    {
+        if( elem_num > max_elements( capacity_ ) )
+        {
+            rehash( elem_num + elem_num / 3 + 1 );
+        }
+    }
+
+    float load_factor() const noexcept
+    {
+        return capacity_ == 0 ? 0.0f : static_cast<float>( size() ) / static_cast<float>( capacity_ );
+    }
+
+    // the table grows when more than 3/4 of the slots are used, longer runs would slow down linear probing
+    float max_load_factor() const noexcept
+    {
+        return 0.75f;
+    }
+
+    void print( std::ostream &os = std::cout, const std::string &delim = " " ) const
+    {
+        for( const auto &elem : *this )
+        {
+            os << elem << delim;
+        }
+    }
+
+    // destroys all elements, the capacity is unchanged
+    void clear() noexcept
+    {
+        for( size_type i = 0; i < capacity_; ++i )
+        {
+            if( ctrl_[i] != EMPTY )
+            {
+                slots_[i].~T();
+            }
+        }
+        if( ctrl_ )
+        {
+            std::fill( ctrl_, ctrl_ + capacity_ + GROUP_WIDTH, ctrl_type( EMPTY ) );
+        }
+        size_ = 0;
+        start_ = 0;
+    }
+
+    bool empty() const noexcept
+    {
+        return size_ == 0;
+    }
+
+    size_type size() const noexcept
+    {
+        return size_;
+    }
+
+    size_type max_size() const noexcept
+    {
+        return max_elements( max_capacity() );
+    }
+
+    std::pair<iterator, bool> insert( const value_type &value )
+    {
+        return insert_unique( value );
+    }
+
+    std::pair<iterator, bool> insert( value_type &&value )
+    {
+        return insert_unique( std::move( value ) );
+    }
+
+    template<typename InputIterator, typename = mystl::RequireInputIterator<InputIterator>>
+    void insert( InputIterator first, InputIterator last )
+    {
+        while( first != last )
+        {
+            insert( *(first++) );
+        }
+    }
+
+    void insert( std::initializer_list<value_type> lst )
+    {
+        insert( lst.begin(), lst.end() );
+    }
+
+    template<typename... Args>
+    std::pair<iterator, bool> emplace( Args&&... args )
+    {
+        return insert_unique( value_type( std::forward<Args>( args )... ) );
+    }
+
+    iterator begin() noexcept
+    {
+        return const_cast<const flat_hash_set *>( this )->begin();
+    }
+
+    const_iterator begin() const noexcept
+    {
+        if( size_ == 0 )
+        {
+            return end();
+        }
+        const_iterator iter( this, start_, capacity_ - 1 );
+        return ++iter;
+    }
+
+    iterator end() noexcept
+    {
+        return const_cast<const flat_hash_set *>( this )->end();
+    }
+
+    const_iterator end() const noexcept
+    {
+        return { this, capacity_, 0 };
+    }
+
+    const_iterator cbegin() const noexcept
+    {
+        return begin();
+    }
+
+    const_iterator cend() const noexcept
+    {
+        return end();
+    }
+
+    hasher hash_function() const
+    {
+        return hash_;
+    }
+
+    key_equal key_eq() const
+    {
+        return equal_;
+    }
+
+    /***
+        returns 1 if an element with that value exists in the container, and zero otherwise.
+    ***/
+    size_type count( const value_type &value ) const
+    {
+        return find_index( value, hash_of( value ) ) == capacity_ ? 0 : 1;
+    }
+
+    /***
+        searches the container for the specify value and returns an iterator to it if found
+        otherwise it returns an iterator to flat_hash_set::end()
+    ***/
+    const_iterator find( const value_type &value ) const
+    {
+        return make_iterator( find_index( value, hash_of( value ) ) );
+    }
+
+    iterator find( const value_type &value )
+    {
+        return const_cast<const flat_hash_set *>( this )->find( value );
+    }
+
+    /**
+       return an iterator pointing to the position immediately following the the element erased,
+       an erase loop from begin() to end() visits every element exactly once
+     **/
+    iterator erase( const_iterator position )
+    {
+        if( position == cend() )
+        {
+            throw flat_hash_set_exception( "flat_hash_set::erase(): the specify iterator is an off-the-end iterator!" );
+        }
+        erase_slot( position.index_ );
+        // the slot is refilled by the next element of its run, which hasn't been visited
+        if( ctrl_[position.index_] != EMPTY )
+        {
+            return position;
+        }
+        return ++position;
+    }
+
+    /**
+       returns the number of elements erased, this is 1 if an element with value existed
+       ( and thus was subsequently erased ), and zero otherwise.
+    **/
+    size_type erase( const value_type &value )
+    {
+        const size_type index = find_index( value, hash_of( value ) );
+        if( index == capacity_ )
+        {
+            return 0;
+        }
+        erase_slot( index );
+        return 1;
+    }
+
+    /**
+       removes as many elements as there are in [first, last), starting from first.
+       erasing moves elements, so last may not point to the same element afterwards
+     **/
+    iterator erase( const_iterator first, const_iterator last )
+    {
+        for( auto n = std::distance( first, last ); n > 0; --n )
+        {
+            first = erase( first );
+        }
+        return first;
+    }
+
+    bool operator==( const flat_hash_set &other ) const
+    {
+        if( this == &other )
+        {
+            return true;
+        }
+        if( size_ != other.size_ )
+        {
+            return false;
+        }
+        for( const auto &elem : *this )
+        {
+            if( other.count( elem ) == 0 )
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool operator!=( const flat_hash_set &other ) const
+    {
+        return !(*this == other);
+    }
+
+private:
+    // the most elements capacity slots can hold
+    static size_type max_elements( size_type capacity ) noexcept
+    {
+        return capacity - capacity / 4;
+    }
+
+    // a power of two, so that the slots can be addressed and every distance fits in distance_type
+    static size_type max_capacity() noexcept
+    {
+        const size_type slot_limit = ( std::numeric_limits<size_type>::max() / sizeof( T ) + 1 ) / 2;
+        const size_type distance_limit = std::numeric_limits<distance_type>::max() / 2 + 1;
+        return slot_limit < distance_limit ? slot_limit : distance_limit;
+    }
+
+    // the bits are mixed so that both the low 7 bits and the home slot depend on the whole value
+    size_type hash_of( const value_type &value ) const
+    {
+        return mix_hash( hash_( value ) );
+    }
+
+    static ctrl_type h2( size_type hash ) noexcept
+    {
+        return static_cast<ctrl_type>( hash & 0x7F );
+    }
+
+    size_type home_slot( size_type hash ) const noexcept
+    {
+        return ( hash >> 7 ) & ( capacity_ - 1 );
+    }
+
+    const_iterator make_iterator( size_type index ) const noexcept
+    {
+        if( index == capacity_ )
+        {
+            return end();
+        }
+        return { this, index, ( start_ - index - 1 ) & ( capacity_ - 1 ) };
+    }
+
+    void set_ctrl( size_type index, ctrl_type ctrl ) noexcept
+    {
+        ctrl_[index] = ctrl;
+        if( index < GROUP_WIDTH )
+        {
+            ctrl_[capacity_ + index] = ctrl;
+        }
+    }
+
+    // returns the slot of value, or capacity_ if not found
+    size_type find_index( const value_type &value, size_type hash ) const
+    {
+        if( size_ == 0 )
+        {
+            return capacity_;
+        }
+        const auto tag = h2( hash );
+        for( size_type pos = home_slot( hash ); ; pos = ( pos + GROUP_WIDTH ) & ( capacity_ - 1 ) )
+        {
+            flat_hash_group group( ctrl_ + pos );
+            for( auto mask = group.match( tag ); mask != 0; mask &= mask - 1 )
+            {
+                const size_type index = ( pos + __builtin_ctz( mask ) ) & ( capacity_ - 1 );
+                if( equal_( slots_[index], value ) )
+                {
+                    return index;
+                }
+            }
+            if( group.match_empty() != 0 )
+            {
+                return capacity_;
+            }
+        }
+    }
+
+    // returns the first empty slot from slot pos
+    size_type find_empty( size_type pos ) const noexcept
+    {
+        for( ; ; pos = ( pos + GROUP_WIDTH ) & ( capacity_ - 1 ) )
+        {
+            const auto mask = flat_hash_group( ctrl_ + pos ).match_empty();
+            if( mask != 0 )
+            {
+                return ( pos + __builtin_ctz( mask ) ) & ( capacity_ - 1 );
+            }
+        }
+    }
+
+    template <typename Value>
+    std::pair<iterator, bool> insert_unique( Value &&value )
+    {
+        auto hash = hash_of( value );
+        const size_type index = find_index( value, hash );
+        if( index != capacity_ )
+        {
+            return { make_iterator( index ), false };
+        }
+        if( size_ + 1 > max_elements( capacity_ ) )
+        {
+            rehash( capacity_ == 0 ? MIN_CAPACITY : capacity_ * 2 );
+        }
+        const size_type home = home_slot( hash );
+        const size_type slot = find_empty( home );
+        ::new ( static_cast<void *>( slots_ + slot ) ) T( std::forward<Value>( value ) );
+        set_ctrl( slot, h2( hash ) );
+        dist_[slot] = static_cast<distance_type>( ( slot - home ) & ( capacity_ - 1 ) );
+        ++size_;
+        if( slot == start_ )
+        {
+            start_ = find_empty( slot );
+        }
+        return { make_iterator( slot ), true };
+    }
+
+    /**
+       erases the element in slot index, then moves back each following element of the run
+       whose home slot is not between the hole and itself, the run ends at an empty slot.
+       the home slots come from the recorded distances, so Hash is never called
+    **/
+    void erase_slot( size_type index ) noexcept
+    {
+        const size_type mask = capacity_ - 1;
+        size_type hole = index;
+        slots_[index].~T();
+        --size_;
+
+        // the table is never full, so the run ends
+        for( size_type next = ( index + 1 ) & mask; ctrl_[next] != EMPTY; next = ( next + 1 ) & mask )
+        {
+            // the element stays if its home slot is nearer to it than the hole
+            const size_type gap = ( next - hole ) & mask;
+            if( dist_[next] < gap )
+            {
+                continue;
+            }
+            ::new ( static_cast<void *>( slots_ + hole ) ) T( std::move( slots_[next] ) );
+            slots_[next].~T();
+            set_ctrl( hole, ctrl_[next] );
+            dist_[hole] = static_cast<distance_type>( dist_[next] - gap );
+            hole = next;
+        }
+        set_ctrl( hole, EMPTY );
+    }
+
+    void allocate_table( size_type capacity )
+    {
+        std::allocator<T> alloc;
+        slots_ = alloc_traits::allocate( alloc, capacity );
+        try
+        {
+            std::unique_ptr<distance_type[]> dist( new distance_type[capacity] );
+            ctrl_ = new ctrl_type[capacity + GROUP_WIDTH];
+            dist_ = dist.release();
+        }
+        catch( ... )
+        {
+            alloc_traits::deallocate( alloc, slots_, capacity );
+            slots_ = nullptr;
+            throw;
+        }
+        std::fill( ctrl_, ctrl_ + capacity + GROUP_WIDTH, ctrl_type( EMPTY ) );
+        capacity_ = capacity;
+    }
+
+    // destroys all elements and frees the table
+    void destroy_table() noexcept
+    {
+        if( !ctrl_ )
+        {
+            return;
+        }
+        for( size_type i = 0; i < capacity_; ++i )
+        {
+            if( ctrl_[i] != EMPTY )
+            {
+                slots_[i].~T();
+            }
+        }
+        std::allocator<T> alloc;
+        alloc_traits::deallocate( alloc, slots_, capacity_ );
+        delete[] ctrl_;
+        delete[] dist_;
+        ctrl_ = nullptr;
+        slots_ = nullptr;
+        dist_ = nullptr;
+        capacity_ = 0;
+        size_ = 0;
+        start_ = 0;
+    }
+
+    void resize_table( size_type new_capacity )
+    {
+        flat_hash_set other( 0, hash_, equal_ );
+        other.allocate_table( new_capacity );
+        for( size_type i = 0; i < capacity_; ++i )
+        {
+            if( ctrl_[i] != EMPTY )
+            {
+                const auto hash = hash_of( slots_[i] );
+                const size_type home = other.home_slot( hash );
+                const size_type slot = other.find_empty( home );
+                ::new ( static_cast<void *>( other.slots_ + slot ) ) T( std::move_if_noexcept( slots_[i] ) );
+                other.set_ctrl( slot, h2( hash ) );
+                other.dist_[slot] = static_cast<distance_type>( ( slot - home ) & ( new_capacity - 1 ) );
+                ++other.size_;
+            }
+        }
+        other.start_ = other.find_empty( 0 );
+        swap( other );
+    }
+};
+
+template <typename T, typename Hash, typename Equal>
+inline std::ostream &operator<<( std::ostream &os, const flat_hash_set<T, Hash, Equal> &coll )
+{
+    coll.print( os );
+    return os;
+}
+
+template <typename T, typename Hash, typename Equal>
+inline void swap( flat_hash_set<T, Hash, Equal> &left, flat_hash_set<T, Hash, Equal> &right ) noexcept
+{
+    left.swap( right );
+}
+
+};    // namespace mystl
+
+
+
+#endif /* _FLAT_HASH_SET_H_ */
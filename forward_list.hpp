@@ -63,7 +63,12 @@ private:
         {
         }
 
-        explicit node( const T &value = T{} ) 
+        node() 
+            : value_(), next_( nullptr ) 
+        {
+        }
+
+        explicit node( const T &value ) 
             : value_( value ), next_( nullptr ) 
         {
         }
@@ -633,10 +638,23 @@ public:
             return;
         }
 
-        // otherwise 
-        auto first = i;
-        auto last = ++iter;
-        return splice_after( position, std::move( other ), first, last );
+        // nothing behind i
+        if( iter == cend() ) 
+        {
+            return;
+        }
+        if( position == cend() ) 
+        {
+            throw forward_list_exception( "forward_list::splice_after(): can't splice after an off-the-end const_iterator" );
+        }
+
+        // otherwise relinks the node behind i, without walking the range
+        auto moved = std::move( i.ptr_->next_ );
+        i.ptr_->next_ = std::move( moved->next_ );
+        moved->next_ = std::move( position.ptr_->next_ );
+        position.ptr_->next_ = std::move( moved );
+        ++size_;
+        --other.size_;
     }
     
     void splice_after( const_iterator position, forward_list &other, const_iterator first, const_iterator last ) 
@@ -862,6 +880,12 @@ inline void swap( forward_list<T> &left, forward_list<T> &right ) noexcept
     left.swap( right );
 }
 
+// forward_list only holds the unique_ptr to its dummy node and the size, no node points back to it
+template <typename T>
+struct is_trivially_relocatable<forward_list<T>> : std::true_type
+{
+};
+
 template <typename T>
 inline std::ostream &operator<<( std::ostream &os, const forward_list<T> &lst ) 
 {
@@ -0,0 +1,550 @@
+/***
+    冻结的散列表
+        1. save() 把 unordered_set 写成紧凑的只读文件：桶偏移数组加上按桶排列的元素
+        2. frozen_unordered_set 通过 mmap 打开文件，无需读取和解析，查找直接在映射的内存上进行
+        3. 文件中只有偏移量，没有指针，可以映射到任意地址
+        4. 支持 trivially copyable 的元素和 std::string，文件只能被相同平台的程序读取
+        5. 依赖 POSIX 的 mmap()
+
+    版本 1.0
+ ***/
+
+#ifndef _FROZEN_UNORDERED_SET_H_
+#define _FROZEN_UNORDERED_SET_H_
+
+#include "unordered_set.hpp"
+#include "hash_policy.hpp"
+#include <string>
+#include <cerrno>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <utility>
+#include <algorithm>
+#include <type_traits>
+#include <system_error>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace mystl {
+
+/**
+   the file starts with the header, the sections follow at offsets aligned to SECTION_ALIGN:
+       offsets   std::uint64_t[bucket_count + 1], the elements of bucket i are entries[offsets[i], offsets[i + 1])
+       entries   frozen_codec<T>::entry_type[size], grouped by bucket
+       pool      the characters of the strings, only for std::string
+**/
+struct frozen_header
+{
+    static const std::uint32_t VERSION = 2;             // 2: buckets picked with the MurmurHash3 finalizer
+    static const std::size_t SECTION_ALIGN = 64;
+
+    char           magic[8];
+    std::uint32_t  version;
+    std::uint32_t  kind;                // frozen_codec<T>::KIND
+    std::uint64_t  entry_size;          // sizeof( frozen_codec<T>::entry_type ), so a wrong T is detected
+    std::uint64_t  size;
+    std::uint64_t  bucket_count;        // a power of two
+    std::uint64_t  offsets_offset;
+    std::uint64_t  entries_offset;
+    std::uint64_t  pool_offset;
+    std::uint64_t  pool_size;
+    std::uint64_t  file_size;
+
+    static const char *signature() noexcept
+    {
+        return "MYSTLFHS";
+    }
+};
+
+/**
+   the file outlives the process, so it can't use std::hash, which may change with the standard library.
+   FNV-1a of the bytes is the same in every run, the bucket is picked by power_of_two_bucket_policy
+**/
+inline std::uint64_t frozen_hash( const void *data, std::size_t length ) noexcept
+{
+    auto bytes = static_cast<const unsigned char *>( data );
+    std::uint64_t hash = 0xcbf29ce484222325ull;
+    for( std::size_t i = 0; i < length; ++i )
+    {
+        hash = ( hash ^ bytes[i] ) * 0x100000001b3ull;
+    }
+    return hash;
+}
+
+/**
+   how an element is stored in the file. a trivially copyable element is stored as it is,
+   and compared byte by byte, so it must not have padding bytes
+**/
+template <typename T>
+struct frozen_codec
+{
+    static_assert( std::is_trivially_copyable<T>::value, "frozen_unordered_set - T must be trivially copyable or std::string" );
+
+    using entry_type = T;
+
+    static const std::uint32_t KIND = 0;
+
+    static std::uint64_t hash( const T &value ) noexcept
+    {
+        return frozen_hash( &value, sizeof( T ) );
+    }
+
+    static entry_type make_entry( const T &value, std::uint64_t, std::string & )
+    {
+        return value;
+    }
+
+    static bool matches( const entry_type &entry, std::uint64_t, const T &value, const char *, std::uint64_t ) noexcept
+    {
+        return std::memcmp( &entry, &value, sizeof( T ) ) == 0;
+    }
+
+    static const T &value( const entry_type &entry, const char *, std::uint64_t ) noexcept
+    {
+        return entry;
+    }
+};
+
+// a string is stored as its hash code and the position of its characters in the pool
+template <>
+struct frozen_codec<std::string>
+{
+    struct entry_type
+    {
+        std::uint64_t hash;
+        std::uint64_t offset;
+        std::uint64_t length;
+    };
+
+    static const std::uint32_t KIND = 1;
+
+    static std::uint64_t hash( const std::string &value ) noexcept
+    {
+        return frozen_hash( value.data(), value.size() );
+    }
+
+    static entry_type make_entry( const std::string &value, std::uint64_t hash, std::string &pool )
+    {
+        entry_type entry = { hash, pool.size(), value.size() };
+        pool += value;
+        return entry;
+    }
+
+    // the strings are only compared if their hash codes are equal, an entry outside the pool never matches
+    static bool matches( const entry_type &entry, std::uint64_t hash, const std::string &value,
+                         const char *pool, std::uint64_t pool_size ) noexcept
+    {
+        return entry.hash == hash && entry.length == value.size() &&
+               entry.offset <= pool_size && entry.length <= pool_size - entry.offset &&
+               std::memcmp( pool + entry.offset, value.data(), value.size() ) == 0;
+    }
+
+    // throw std::system_error if the entry lies outside the pool, i.e. the file is corrupted
+    static std::string value( const entry_type &entry, const char *pool, std::uint64_t pool_size )
+    {
+        if( entry.offset > pool_size || entry.length > pool_size - entry.offset )
+        {
+            throw std::system_error( EINVAL, std::generic_category(), "frozen_unordered_set - a string lies outside the pool" );
+        }
+        return std::string( pool + entry.offset, entry.length );
+    }
+};
+
+/**
+   a read-only hash set in a file written by save(). opening the file maps it without reading it,
+   the kernel pages the buckets in on demand, so a set of any size is ready at once,
+   and processes which open the same file share its pages.
+
+   a frozen_unordered_set is never modified, so many threads may use it at the same time
+**/
+template <typename T>
+class frozen_unordered_set
+{
+public:
+    using key_type        = T;
+    using value_type      = T;
+    using size_type       = std::size_t;
+    using codec_type      = frozen_codec<T>;
+
+private:
+    using entry_type = typename codec_type::entry_type;
+
+    void                 *mapping_ = nullptr;
+    size_type             mapping_size_ = 0;
+    const frozen_header  *header_ = nullptr;
+    const std::uint64_t  *offsets_ = nullptr;
+    const entry_type     *entries_ = nullptr;
+    const char           *pool_ = nullptr;
+
+public:
+    frozen_unordered_set() noexcept = default;
+
+    /**
+       maps the file at path, which must be written by save() for the same T.
+       throw std::system_error if the file can't be opened or mapped, or if its header is invalid
+    **/
+    explicit frozen_unordered_set( const std::string &path )
+    {
+        const int fd = ::open( path.c_str(), O_RDONLY | O_CLOEXEC );
+        if( fd < 0 )
+        {
+            throw std::system_error( errno, std::generic_category(), "frozen_unordered_set - can't open " + path );
+        }
+
+        struct stat status;
+        if( ::fstat( fd, &status ) != 0 )
+        {
+            const int error = errno;
+            ::close( fd );
+            throw std::system_error( error, std::generic_category(), "frozen_unordered_set - fstat() failed" );
+        }
+        mapping_size_ = static_cast<size_type>( status.st_size );
+        if( mapping_size_ < sizeof( frozen_header ) )
+        {
+            ::close( fd );
+            throw std::system_error( EINVAL, std::generic_category(), "frozen_unordered_set - the file is too small" );
+        }
+
+        auto ptr = ::mmap( nullptr, mapping_size_, PROT_READ, MAP_SHARED, fd, 0 );
+        const int error = errno;
+        ::close( fd );
+        if( ptr == MAP_FAILED )
+        {
+            throw std::system_error( error, std::generic_category(), "frozen_unordered_set - mmap() failed" );
+        }
+        mapping_ = ptr;
+
+        try
+        {
+            attach();
+        }
+        catch( ... )
+        {
+            unmap();
+            throw;
+        }
+    }
+
+    frozen_unordered_set( const frozen_unordered_set & ) = delete;
+    frozen_unordered_set &operator=( const frozen_unordered_set & ) = delete;
+
+    frozen_unordered_set( frozen_unordered_set &&other ) noexcept
+    {
+        swap( other );
+    }
+
+    frozen_unordered_set &operator=( frozen_unordered_set &&other ) noexcept
+    {
+        if( this != &other )
+        {
+            unmap();
+            swap( other );
+        }
+        return *this;
+    }
+
+    ~frozen_unordered_set()
+    {
+        unmap();
+    }
+
+    void swap( frozen_unordered_set &other ) noexcept
+    {
+        using std::swap;
+        swap( mapping_, other.mapping_ );
+        swap( mapping_size_, other.mapping_size_ );
+        swap( header_, other.header_ );
+        swap( offsets_, other.offsets_ );
+        swap( entries_, other.entries_ );
+        swap( pool_, other.pool_ );
+    }
+
+    size_type size() const noexcept
+    {
+        return header_ ? static_cast<size_type>( header_->size ) : 0;
+    }
+
+    bool empty() const noexcept
+    {
+        return size() == 0;
+    }
+
+    size_type bucket_count() const noexcept
+    {
+        return header_ ? static_cast<size_type>( header_->bucket_count ) : 0;
+    }
+
+    bool contains( const value_type &value ) const
+    {
+        if( empty() )
+        {
+            return false;
+        }
+        const std::uint64_t hash = codec_type::hash( value );
+        const size_type pos = power_of_two_bucket_policy::bucket_index( static_cast<size_type>( hash ), bucket_count() );
+
+        // the offsets are not validated when the file is opened, a corrupted bucket is clamped to the entries
+        const std::uint64_t last = std::min( offsets_[pos + 1], header_->size );
+        for( std::uint64_t i = offsets_[pos]; i < last; ++i )
+        {
+            if( codec_type::matches( entries_[i], hash, value, pool_, header_->pool_size ) )
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    size_type count( const value_type &value ) const
+    {
+        return contains( value ) ? 1 : 0;
+    }
+
+    /**
+       calls func( value ) for every element, in the order of the buckets.
+       throw std::system_error if a string lies outside the file
+    **/
+    template <typename Function>
+    void for_each( Function func ) const
+    {
+        for( size_type i = 0; i < size(); ++i )
+        {
+            func( codec_type::value( entries_[i], pool_, header_->pool_size ) );
+        }
+    }
+
+private:
+    // checks the header, and that every section lies inside the mapping
+    void attach()
+    {
+        auto header = static_cast<const frozen_header *>( mapping_ );
+        const std::uint64_t file_size = mapping_size_;
+        const bool valid =
+            std::memcmp( header->magic, frozen_header::signature(), sizeof( header->magic ) ) == 0 &&
+            header->version == frozen_header::VERSION &&
+            header->kind == codec_type::KIND &&
+            header->entry_size == sizeof( entry_type ) &&
+            header->file_size == file_size &&
+            header->bucket_count != 0 && ( header->bucket_count & ( header->bucket_count - 1 ) ) == 0 &&
+            fits( header->offsets_offset, header->bucket_count + 1, sizeof( std::uint64_t ), file_size ) &&
+            fits( header->entries_offset, header->size, sizeof( entry_type ), file_size ) &&
+            fits( header->pool_offset, header->pool_size, 1, file_size ) &&
+            header->offsets_offset % alignof( std::uint64_t ) == 0 &&
+            header->entries_offset % alignof( entry_type ) == 0;
+        if( !valid )
+        {
+            throw std::system_error( EINVAL, std::generic_category(), "frozen_unordered_set - the file is not a frozen set of this type" );
+        }
+
+        auto base = static_cast<const char *>( mapping_ );
+        header_ = header;
+        offsets_ = reinterpret_cast<const std::uint64_t *>( base + header->offsets_offset );
+        entries_ = reinterpret_cast<const entry_type *>( base + header->entries_offset );
+        pool_ = base + header->pool_offset;
+    }
+
+    // returns true if num objects of object_size bytes at offset are inside a file of file_size bytes
+    static bool fits( std::uint64_t offset, std::uint64_t num, std::uint64_t object_size, std::uint64_t file_size ) noexcept
+    {
+        return offset <= file_size && num <= ( file_size - offset ) / object_size;
+    }
+
+    void unmap() noexcept
+    {
+        if( mapping_ )
+        {
+            ::munmap( mapping_, mapping_size_ );
+        }
+        mapping_ = nullptr;
+        mapping_size_ = 0;
+        header_ = nullptr;
+        offsets_ = nullptr;
+        entries_ = nullptr;
+        pool_ = nullptr;
+    }
+};
+
+template <typename T>
+inline void swap( frozen_unordered_set<T> &left, frozen_unordered_set<T> &right ) noexcept
+{
+    left.swap( right );
+}
+
+inline std::uint64_t frozen_align( std::uint64_t offset ) noexcept
+{
+    return ( offset + frozen_header::SECTION_ALIGN - 1 ) / frozen_header::SECTION_ALIGN * frozen_header::SECTION_ALIGN;
+}
+
+// writes length bytes at offset, retries short writes, throw std::system_error on failure
+inline void frozen_write( int fd, std::uint64_t offset, const void *data, std::size_t length )
+{
+    auto bytes = static_cast<const char *>( data );
+    while( length > 0 )
+    {
+        const auto written = ::pwrite( fd, bytes, length, static_cast<off_t>( offset ) );
+        if( written < 0 )
+        {
+            if( errno == EINTR )
+            {
+                continue;
+            }
+            throw std::system_error( errno, std::generic_category(), "save() - pwrite() failed" );
+        }
+        bytes += written;
+        offset += static_cast<std::uint64_t>( written );
+        length -= static_cast<std::size_t>( written );
+    }
+}
+
+// flushes the directory entries of the directory which holds path, so a rename() in it survives a crash
+inline void frozen_sync_directory( const std::string &path )
+{
+    const auto slash = path.find_last_of( '/' );
+    const std::string directory = slash == std::string::npos ? "." : slash == 0 ? "/" : path.substr( 0, slash );
+    const int fd = ::open( directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC );
+    if( fd < 0 )
+    {
+        throw std::system_error( errno, std::generic_category(), "save() - can't open " + directory );
+    }
+    const int result = ::fsync( fd );
+    const int error = errno;
+    ::close( fd );
+    if( result != 0 )
+    {
+        throw std::system_error( error, std::generic_category(), "save() - fsync() of " + directory + " failed" );
+    }
+}
+
+/**
+   writes the elements of set to the file at path, in the format frozen_unordered_set maps.
+   the file is written to a unique temporary file next to path and renamed over it, 
+   so a reader never sees half a file, and concurrent writers don't write into the same file.
+   throw std::system_error if the file can't be written
+**/
+template <typename T, typename Hash, typename Equal, bool CacheHash, typename BucketPolicy>
+void save( const unordered_set<T, Hash, Equal, CacheHash, BucketPolicy> &set, const std::string &path )
+{
+    using codec_type = frozen_codec<T>;
+    using entry_type = typename codec_type::entry_type;
+
+    const std::uint64_t size = set.size();
+    const std::uint64_t bucket_count = power_of_two_bucket_policy::next_bucket_count( set.size() );
+
+    // the elements are bucket sorted by their frozen hash codes
+    mystl::vector<std::uint64_t> offsets;
+    mystl::vector<std::uint64_t> hashes;
+    offsets.resize( bucket_count + 1 );
+    hashes.resize_default_init( set.size() );
+    std::uint64_t *counts = offsets.begin();
+    std::uint64_t *hash_codes = hashes.begin();
+
+    {
+        std::size_t i = 0;
+        for( const auto &value : set )
+        {
+            hash_codes[i] = codec_type::hash( value );
+            ++counts[power_of_two_bucket_policy::bucket_index( static_cast<std::size_t>( hash_codes[i] ), bucket_count ) + 1];
+            ++i;
+        }
+    }
+    for( std::uint64_t i = 0; i < bucket_count; ++i )
+    {
+        counts[i + 1] += counts[i];
+    }
+
+    mystl::vector<entry_type> entries;
+    entries.resize_default_init( set.size() );
+    mystl::vector<std::uint64_t> next( offsets.begin(), offsets.end() - 1 );
+    std::string pool;
+    {
+        std::size_t i = 0;
+        for( const auto &value : set )
+        {
+            const auto pos = power_of_two_bucket_policy::bucket_index( static_cast<std::size_t>( hash_codes[i] ), bucket_count );
+            entries.begin()[next.begin()[pos]++] = codec_type::make_entry( value, hash_codes[i], pool );
+            ++i;
+        }
+    }
+
+    frozen_header header;
+    std::memset( &header, 0, sizeof( header ) );
+    std::memcpy( header.magic, frozen_header::signature(), sizeof( header.magic ) );
+    header.version = frozen_header::VERSION;
+    header.kind = codec_type::KIND;
+    header.entry_size = sizeof( entry_type );
+    header.size = size;
+    header.bucket_count = bucket_count;
+    header.offsets_offset = frozen_align( sizeof( frozen_header ) );
+    header.entries_offset = frozen_align( header.offsets_offset + ( bucket_count + 1 ) * sizeof( std::uint64_t ) );
+    header.pool_offset = frozen_align( header.entries_offset + size * sizeof( entry_type ) );
+    header.pool_size = pool.size();
+    header.file_size = header.pool_offset + header.pool_size;
+
+    std::string temp_path = path + ".XXXXXX";
+    const int fd = ::mkstemp( &temp_path[0] );
+    if( fd < 0 )
+    {
+        throw std::system_error( errno, std::generic_category(), "save() - can't create " + temp_path );
+    }
+    try
+    {
+        // mkstemp() creates the file readable by its owner only
+        if( ::fcntl( fd, F_SETFD, FD_CLOEXEC ) != 0 || ::fchmod( fd, 0644 ) != 0 )
+        {
+            throw std::system_error( errno, std::generic_category(), "save() - can't set up " + temp_path );
+        }
+        if( ::ftruncate( fd, static_cast<off_t>( header.file_size ) ) != 0 )
+        {
+            throw std::system_error( errno, std::generic_category(), "save() - ftruncate() failed" );
+        }
+        frozen_write( fd, 0, &header, sizeof( header ) );
+        frozen_write( fd, header.offsets_offset, offsets.begin(), offsets.size() * sizeof( std::uint64_t ) );
+        frozen_write( fd, header.entries_offset, entries.begin(), entries.size() * sizeof( entry_type ) );
+        frozen_write( fd, header.pool_offset, pool.data(), pool.size() );
+        if( ::fsync( fd ) != 0 )
+        {
+            throw std::system_error( errno, std::generic_category(), "save() - fsync() failed" );
+        }
+    }
+    catch( ... )
+    {
+        ::close( fd );
+        ::unlink( temp_path.c_str() );
+        throw;
+    }
+    ::close( fd );
+    if( ::rename( temp_path.c_str(), path.c_str() ) != 0 )
+    {
+        const int error = errno;
+        ::unlink( temp_path.c_str() );
+        throw std::system_error( error, std::generic_category(), "save() - can't rename " + temp_path );
+    }
+    frozen_sync_directory( path );
+}
+
+/**
+   replaces the elements of set by the elements of the file at path, which save() wrote.
+   the buckets are grown once, but every element is still hashed and inserted,
+   to look the elements up without loading them, open the file as a frozen_unordered_set
+**/
+template <typename T, typename Hash, typename Equal, bool CacheHash, typename BucketPolicy>
+void load( unordered_set<T, Hash, Equal, CacheHash, BucketPolicy> &set, const std::string &path )
+{
+    frozen_unordered_set<T> frozen( path );
+    set.clear();
+    set.reserve( frozen.size() );
+    frozen.for_each( [&set]( const T &value )
+    {
+        set.insert( value );
+    } );
+}
+
+
+};    // namespace mystl
+
+
+#endif /* _FROZEN_UNORDERED_SET_H_ */
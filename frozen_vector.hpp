@@ -0,0 +1,256 @@
+/***
+    frozen_vector
+        1. vector 的不可变快照，由引用计数共享，复制快照的代价为 O(1)
+        2. 从 vector 移动构造快照的代价为 O(1)，不复制任何元素
+        3. 多个线程可以同时读取同一个快照
+        4. 引入异常，对于不合法的操作会抛出异常
+
+    版本 1.0
+ ***/
+
+#ifndef _FROZEN_VECTOR_H_
+#define _FROZEN_VECTOR_H_
+
+#include "vector.hpp"
+#include <memory>
+#include <atomic>
+#include <cstddef>
+#include <iterator>
+#include <stdexcept>
+
+namespace mystl {
+
+/**
+   a writer builds a vector, then freezes it with std::move, which costs O(1).
+   readers share the snapshot, and keep it alive as long as they need while the writer
+   is building the next version, the elements are destroyed when the last snapshot goes away.
+
+   copies of a frozen_vector may be used from different threads freely,
+   to replace a frozen_vector shared by several threads use atomic_load() / atomic_store()
+**/
+template <typename T, typename Allocator = std::allocator<T>, typename GrowthPolicy = double_growth>
+class frozen_vector
+{
+public:
+    using vector_type              = mystl::vector<T, Allocator, GrowthPolicy>;
+    using value_type               = T;
+    using pointer                  = const T*;
+    using const_pointer            = const T*;
+    using reference                = const T&;
+    using const_reference          = const T&;
+    using size_type                = std::size_t;
+    using difference_type          = std::ptrdiff_t;
+    using iterator                 = const T*;
+    using const_iterator           = const T*;
+    using reverse_iterator         = std::reverse_iterator<const T*>;
+    using const_reverse_iterator   = std::reverse_iterator<const T*>;
+
+private:
+    std::shared_ptr<const vector_type> vec_;    // nullptr for an empty snapshot
+
+public:
+    frozen_vector() noexcept = default;
+
+    // takes over the elements of vec, no element is copied
+    explicit frozen_vector(vector_type &&vec)
+        : vec_(std::make_shared<const vector_type>(std::move(vec)))
+    {
+    }
+
+    // copies the elements of vec
+    explicit frozen_vector(const vector_type &vec)
+        : vec_(std::make_shared<const vector_type>(vec))
+    {
+    }
+
+    frozen_vector(const frozen_vector &) = default;
+    frozen_vector(frozen_vector &&) noexcept = default;
+    frozen_vector &operator=(const frozen_vector &) = default;
+    frozen_vector &operator=(frozen_vector &&) noexcept = default;
+
+    /**
+       returns a mutable copy of the elements,
+       the writer may start the next version from it
+    **/
+    vector_type thaw() const
+    {
+        return vec_ ? *vec_ : vector_type();
+    }
+
+    const_iterator begin() const noexcept
+    {
+        return vec_ ? vec_->begin() : nullptr;
+    }
+
+    const_iterator end() const noexcept
+    {
+        return vec_ ? vec_->end() : nullptr;
+    }
+
+    const_iterator cbegin() const noexcept
+    {
+        return begin();
+    }
+
+    const_iterator cend() const noexcept
+    {
+        return end();
+    }
+
+    const_reverse_iterator rbegin() const noexcept
+    {
+        return const_reverse_iterator(end());
+    }
+
+    const_reverse_iterator rend() const noexcept
+    {
+        return const_reverse_iterator(begin());
+    }
+
+    const_reverse_iterator crbegin() const noexcept
+    {
+        return rbegin();
+    }
+
+    const_reverse_iterator crend() const noexcept
+    {
+        return rend();
+    }
+
+    const_pointer data() const noexcept
+    {
+        return begin();
+    }
+
+    size_type size() const noexcept
+    {
+        return end() - begin();
+    }
+
+    bool empty() const noexcept
+    {
+        return begin() == end();
+    }
+
+    const_reference operator[](size_type n) const
+    {
+        if (n < size())
+        {
+            return begin()[n];
+        }
+        throw std::out_of_range("frozen_vector::operator[] - the specify index is out of bound");
+    }
+
+    const_reference at(size_type n) const
+    {
+        if (n < size())
+        {
+            return begin()[n];
+        }
+        throw std::out_of_range("frozen_vector::at() - the specify index is out of bound");
+    }
+
+    const_reference front() const
+    {
+        if (empty())
+        {
+            throw std::length_error("frozen_vector::front() - the frozen_vector is empty");
+        }
+        return *begin();
+    }
+
+    const_reference back() const
+    {
+        if (empty())
+        {
+            throw std::length_error("frozen_vector::back() - the frozen_vector is empty");
+        }
+        return *(end() - 1);
+    }
+
+    // number of frozen_vector sharing this snapshot
+    long use_count() const noexcept
+    {
+        return vec_.use_count();
+    }
+
+    void swap(frozen_vector &other) noexcept
+    {
+        vec_.swap(other.vec_);
+    }
+
+    friend frozen_vector atomic_load(const frozen_vector *snapshot)
+    {
+        frozen_vector result;
+        result.vec_ = std::atomic_load(&snapshot->vec_);
+        return result;
+    }
+
+    friend void atomic_store(frozen_vector *snapshot, frozen_vector other)
+    {
+        std::atomic_store(&snapshot->vec_, std::move(other.vec_));
+    }
+
+    bool operator==(const frozen_vector &other) const noexcept
+    {
+        if (vec_ == other.vec_)    // the same snapshot
+        {
+            return true;
+        }
+        return size() == other.size() && mystl::equal(begin(), end(), other.begin());
+    }
+
+    bool operator!=(const frozen_vector &other) const noexcept
+    {
+        return !(*this == other);
+    }
+
+    bool operator<(const frozen_vector &other) const noexcept
+    {
+        return mystl::lexicographical_compare(begin(), end(), other.begin(), other.end());
+    }
+
+    bool operator>(const frozen_vector &other) const noexcept
+    {
+        return other < *this;
+    }
+
+    bool operator>=(const frozen_vector &other) const noexcept
+    {
+        return !(*this < other);
+    }
+
+    bool operator<=(const frozen_vector &other) const noexcept
+    {
+        return !(other < *this);
+    }
+};
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+void swap(frozen_vector<T, Allocator, GrowthPolicy> &first, frozen_vector<T, Allocator, GrowthPolicy> &second) noexcept
+{
+    first.swap(second);
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+std::ostream &operator<<(std::ostream &os, const frozen_vector<T, Allocator, GrowthPolicy> &vec)
+{
+    for (const auto &elem : vec)
+    {
+        os << elem << " ";
+    }
+    return os;
+}
+
+// freezes vec, no element is copied
+template <typename T, typename Allocator, typename GrowthPolicy>
+frozen_vector<T, Allocator, GrowthPolicy> freeze(vector<T, Allocator, GrowthPolicy> &&vec)
+{
+    return frozen_vector<T, Allocator, GrowthPolicy>(std::move(vec));
+}
+
+
+}; // namespace mystl
+
+
+#endif /* _FROZEN_VECTOR_H_ */
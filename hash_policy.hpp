@@ -0,0 +1,118 @@
+/***
+    散列表的桶策略
+        1. 决定散列表的桶数，以及元素散列值对应的桶
+        2. prime_bucket_policy：桶数为素数，散列值对桶数取模
+        3. power_of_two_bucket_policy：桶数为 2 的幂，散列值混合之后取低位，不需要除法
+
+    版本 1.0
+ ***/
+
+#ifndef _HASH_POLICY_H_
+#define _HASH_POLICY_H_
+
+#include <limits>
+#include <cstdint>
+#include <cstddef>
+#include <iterator>
+#include <algorithm>
+
+namespace mystl {
+
+/**
+   std::hash of the integers is the identity, so the low bits of a hash code may not depend on the rest.
+   this is the 64-bit finalizer of MurmurHash3, every bit of the result depends on every bit of the hash code,
+   so the low bits which pick a bucket are as good as the high ones
+**/
+inline std::size_t mix_hash( std::size_t hash ) noexcept
+{
+    std::uint64_t mixed = static_cast<std::uint64_t>( hash );
+    mixed ^= mixed >> 33;
+    mixed *= 0xff51afd7ed558ccdull;
+    mixed ^= mixed >> 33;
+    mixed *= 0xc4ceb9fe1a85ec53ull;
+    mixed ^= mixed >> 33;
+    return static_cast<std::size_t>( mixed );
+}
+
+/**
+   the bucket count is a prime, and an element goes to the bucket of its hash code modulo the bucket count,
+   a prime modulus uses every bit of the hash code, so even a poor hash function spreads well
+**/
+struct prime_bucket_policy
+{
+    // returns the smallest bucket count which is not less than n, or the largest bucket count
+    static std::size_t next_bucket_count( std::size_t n ) noexcept
+    {
+        auto first = std::begin( primes() );
+        auto last = std::end( primes() );
+
+        auto iter = std::lower_bound( first, last, n );
+        return iter == last ? *( last - 1 ) : *iter;
+    }
+
+    static std::size_t bucket_index( std::size_t hash, std::size_t bucket_count ) noexcept
+    {
+        return hash % bucket_count;
+    }
+
+    static std::size_t max_bucket_count() noexcept
+    {
+        return *( std::end( primes() ) - 1 );
+    }
+
+private:
+    using prime_array = std::size_t[28];
+
+    // prime number serve as bucket count
+    static const prime_array &primes() noexcept
+    {
+        static const prime_array primes_ =
+        {
+            53u, 97u, 193u, 389u, 769u, 1543u, 3079u, 6151u, 12289u, 24593u, 49157u,
+            98317u, 196613u, 393241u, 786433u, 1572869u, 3145739u, 6291469u, 12582917u,
+            25165843u, 50331653u, 100663319u, 201326611u, 402653189u, 805306457u,
+            1610612741u, 3221225473u, 4294967291u,
+        };
+        return primes_;
+    }
+};
+
+/**
+   the bucket count is a power of two, and an element goes to the bucket of the low bits of its mixed hash code,
+   a mask and a multiplication are much cheaper than a division by a prime
+**/
+struct power_of_two_bucket_policy
+{
+    static std::size_t next_bucket_count( std::size_t n ) noexcept
+    {
+        if( n >= max_bucket_count() )
+        {
+            return max_bucket_count();
+        }
+        std::size_t count = MIN_BUCKET_COUNT;
+        while( count < n )
+        {
+            count <<= 1;
+        }
+        return count;
+    }
+
+    static std::size_t bucket_index( std::size_t hash, std::size_t bucket_count ) noexcept
+    {
+        return mix_hash( hash ) & ( bucket_count - 1 );
+    }
+
+    static std::size_t max_bucket_count() noexcept
+    {
+        return std::size_t( 1 ) << ( std::numeric_limits<std::size_t>::digits - 1 );
+    }
+
+private:
+    static const std::size_t MIN_BUCKET_COUNT = 16;
+};
+
+
+};    // namespace mystl
+
+
+#endif /* _HASH_POLICY_H_ */
@@ -2,6 +2,19 @@
 #define _MEMORY_H_
 
 #include <memory>
+#include <new>
+#include <limits>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
 
 // In C++14 you can use std::make_unique(), but not in C++11
 // so this is our own version
@@ -10,4 +23,418 @@ std::unique_ptr<T> make_unique( Ts&&... params ) {
     return std::unique_ptr<T>( new T( std::forward<Ts>(params)... ) );
 }
 
+namespace mystl {
+
+/**
+   a type is trivially relocatable if moving an object to a new address and then 
+   destroying the source is equivalent to copying its bytes, so containers can relocate
+   such elements with memcpy/memmove instead of a move and a destroy per element.
+
+   every trivially copyable type is trivially relocatable, specialize this trait for 
+   your own types as long as they never hold a pointer into themselves.
+   note: std::string is NOT trivially relocatable in libstdc++, its short string buffer
+   is referenced by an internal pointer
+**/
+template <typename T>
+struct is_trivially_relocatable 
+    : std::integral_constant<bool, std::is_trivially_copyable<T>::value>
+{
+};
+
+template <typename T>
+struct is_trivially_relocatable<std::allocator<T>> : std::true_type
+{
+};
+
+template <typename T, typename Deleter>
+struct is_trivially_relocatable<std::unique_ptr<T, Deleter>> : is_trivially_relocatable<Deleter>
+{
+};
+
+template <typename T>
+struct is_trivially_relocatable<std::shared_ptr<T>> : std::true_type
+{
+};
+
+template <typename T1, typename T2>
+struct is_trivially_relocatable<std::pair<T1, T2>> 
+    : std::integral_constant<bool, is_trivially_relocatable<T1>::value && is_trivially_relocatable<T2>::value>
+{
+};
+
+/**
+   an allocator is able to grow memory in place if it has a member function 
+
+       T *reallocate( T *ptr, std::size_t old_n, std::size_t new_n );
+
+   which behaves like std::realloc: the first min(old_n, new_n) objects are moved 
+   bytewise, and the old memory is left untouched if std::bad_alloc is thrown.
+   containers only call it for trivially relocatable element types
+**/
+template <typename Allocator>
+struct allocator_can_reallocate
+{
+private:
+    using pointer = typename std::allocator_traits<Allocator>::pointer;
+
+    template <typename A>
+    static auto test( int ) -> decltype( std::declval<A &>().reallocate( std::declval<pointer>(), std::size_t(), std::size_t() ), 
+                                         std::true_type() );
+
+    template <typename A>
+    static std::false_type test( ... );
+
+public:
+    static constexpr bool value = decltype( test<Allocator>( 0 ) )::value;
+};
+
+/**
+   monotonic_arena hands out memory by bumping a pointer inside big blocks,
+   individual deallocations don't give memory back and all memory is returned 
+   at once when the arena is released or destroyed.
+
+   allocations made one after another sit next to each other in memory,
+   which makes it suitable for per-request scratch containers.
+   the arena is not thread safe.
+**/
+class monotonic_arena
+{
+private:
+    struct block
+    {
+        block      *next_;
+        std::size_t size_;            // bytes of the whole block, include this header
+    };
+
+    static constexpr std::size_t DEFAULT_BLOCK_SIZE = 4096;
+    static constexpr std::size_t GROWTH_RATE        = 2;
+
+    block       *blocks_ = nullptr;   // the most recently allocated block
+    char        *cur_    = nullptr;   // first free byte in the current block
+    char        *end_    = nullptr;   // one past the end of the current block
+    std::size_t  next_block_size_;
+    std::size_t  bytes_allocated_ = 0;
+
+public:
+    explicit monotonic_arena( std::size_t initial_block_size = DEFAULT_BLOCK_SIZE ) noexcept
+        : next_block_size_( initial_block_size < sizeof( block ) * 2 ? sizeof( block ) * 2 : initial_block_size )
+    {
+    }
+
+    monotonic_arena( const monotonic_arena & ) = delete;
+    monotonic_arena &operator=( const monotonic_arena & ) = delete;
+
+    ~monotonic_arena() noexcept
+    {
+        release();
+    }
+
+    /**
+       returns size bytes aligned to alignment, alignment must be a power of two
+       throw std::bad_alloc if the memory can't be obtained
+    **/
+    void *allocate( std::size_t size, std::size_t alignment = alignof( std::max_align_t ) )
+    {
+        // aligning may move ptr past the end of the block, the size check alone would wrap around
+        auto ptr = align_up( cur_, alignment );
+        if( !ptr || ptr > end_ || static_cast<std::size_t>( end_ - ptr ) < size )
+        {
+            if( size > std::numeric_limits<std::size_t>::max() - alignment - sizeof( block ) )
+            {
+                throw std::bad_alloc();
+            }
+            add_block( size + alignment );
+            ptr = align_up( cur_, alignment );
+        }
+        cur_ = ptr + size;
+        bytes_allocated_ += size;
+        return ptr;
+    }
+
+    /**
+       memory is only reclaimed by release(), but the most recent allocation
+       is rolled back so that a short-lived buffer can be reused immediately
+    **/
+    void deallocate( void *ptr, std::size_t size ) noexcept
+    {
+        if( static_cast<char *>( ptr ) + size == cur_ )
+        {
+            cur_ = static_cast<char *>( ptr );
+            bytes_allocated_ -= size;
+        }
+    }
+
+    /**
+       if ptr is the most recent allocation and the current block has enough room, 
+       it simply grows in place, otherwise a new chunk is allocated and the bytes are copied
+    **/
+    void *reallocate( void *ptr, std::size_t old_size, std::size_t new_size, 
+                      std::size_t alignment = alignof( std::max_align_t ) )
+    {
+        auto first = static_cast<char *>( ptr );
+        if( first + old_size == cur_ && static_cast<std::size_t>( end_ - first ) >= new_size )
+        {
+            cur_ = first + new_size;
+            bytes_allocated_ = bytes_allocated_ - old_size + new_size;
+            return ptr;
+        }
+        auto new_ptr = allocate( new_size, alignment );
+        std::memcpy( new_ptr, ptr, old_size < new_size ? old_size : new_size );
+        return new_ptr;
+    }
+
+    // returns all blocks to the system, every pointer handed out becomes invalid
+    void release() noexcept
+    {
+        while( blocks_ )
+        {
+            auto next = blocks_->next_;
+            ::operator delete( blocks_ );
+            blocks_ = next;
+        }
+        cur_ = end_ = nullptr;
+        bytes_allocated_ = 0;
+    }
+
+    // bytes handed out by allocate() and not yet rolled back
+    std::size_t bytes_allocated() const noexcept
+    {
+        return bytes_allocated_;
+    }
+
+private:
+    static char *align_up( char *ptr, std::size_t alignment ) noexcept
+    {
+        if( !ptr )
+        {
+            return nullptr;
+        }
+        auto addr = reinterpret_cast<std::uintptr_t>( ptr );
+        addr = ( addr + alignment - 1 ) & ~static_cast<std::uintptr_t>( alignment - 1 );
+        return reinterpret_cast<char *>( addr );
+    }
+
+    void add_block( std::size_t min_size )
+    {
+        std::size_t size = next_block_size_;
+        if( size - sizeof( block ) < min_size )
+        {
+            size = min_size + sizeof( block );
+        }
+
+        auto new_block = static_cast<block *>( ::operator new( size ) );
+        new_block->next_ = blocks_;
+        new_block->size_ = size;
+        blocks_ = new_block;
+
+        cur_ = reinterpret_cast<char *>( new_block ) + sizeof( block );
+        end_ = reinterpret_cast<char *>( new_block ) + size;
+        next_block_size_ = size * GROWTH_RATE;
+    }
+};
+
+/**
+   an allocator which gets its memory from a monotonic_arena,
+   the arena must outlive every container using this allocator
+**/
+template <typename T>
+class arena_allocator
+{
+    template <typename U> friend class arena_allocator;
+
+public:
+    using value_type                             = T;
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap            = std::true_type;
+
+    arena_allocator( monotonic_arena &arena ) noexcept
+        : arena_( &arena )
+    {
+    }
+
+    template <typename U>
+    arena_allocator( const arena_allocator<U> &other ) noexcept
+        : arena_( other.arena_ )
+    {
+    }
+
+    T *allocate( std::size_t n )
+    {
+        if( n > std::numeric_limits<std::size_t>::max() / sizeof( T ) )
+        {
+            throw std::bad_alloc();
+        }
+        return static_cast<T *>( arena_->allocate( n * sizeof( T ), alignof( T ) ) );
+    }
+
+    void deallocate( T *ptr, std::size_t n ) noexcept
+    {
+        arena_->deallocate( ptr, n * sizeof( T ) );
+    }
+
+    T *reallocate( T *ptr, std::size_t old_n, std::size_t new_n )
+    {
+        if( new_n > std::numeric_limits<std::size_t>::max() / sizeof( T ) )
+        {
+            throw std::bad_alloc();
+        }
+        return static_cast<T *>( arena_->reallocate( ptr, old_n * sizeof( T ), new_n * sizeof( T ), alignof( T ) ) );
+    }
+
+    monotonic_arena *arena() const noexcept
+    {
+        return arena_;
+    }
+
+    template <typename U>
+    bool operator==( const arena_allocator<U> &other ) const noexcept
+    {
+        return arena_ == other.arena_;
+    }
+
+    template <typename U>
+    bool operator!=( const arena_allocator<U> &other ) const noexcept
+    {
+        return !( *this == other );
+    }
+
+private:
+    monotonic_arena *arena_;
+};
+
+/**
+   an allocator built on std::malloc/std::realloc/std::free,
+   std::realloc can extend a block in place, or remap the pages of a big block, without copying
+**/
+template <typename T>
+class malloc_allocator
+{
+    static_assert( alignof( T ) <= alignof( std::max_align_t ), "malloc_allocator - T is over-aligned" );
+
+public:
+    using value_type = T;
+
+    malloc_allocator() noexcept = default;
+
+    template <typename U>
+    malloc_allocator( const malloc_allocator<U> & ) noexcept
+    {
+    }
+
+    T *allocate( std::size_t n )
+    {
+        return reallocate( nullptr, 0, n );
+    }
+
+    void deallocate( T *ptr, std::size_t ) noexcept
+    {
+        std::free( ptr );
+    }
+
+    T *reallocate( T *ptr, std::size_t, std::size_t new_n )
+    {
+        if( new_n > std::numeric_limits<std::size_t>::max() / sizeof( T ) )
+        {
+            throw std::bad_alloc();
+        }
+        // std::realloc( ptr, 0 ) may free ptr and return nullptr
+        auto bytes = new_n == 0 ? 1 : new_n * sizeof( T );
+        auto new_ptr = std::realloc( ptr, bytes );
+        if( !new_ptr )
+        {
+            throw std::bad_alloc();
+        }
+        return static_cast<T *>( new_ptr );
+    }
+
+    template <typename U>
+    bool operator==( const malloc_allocator<U> & ) const noexcept
+    {
+        return true;
+    }
+
+    template <typename U>
+    bool operator!=( const malloc_allocator<U> & ) const noexcept
+    {
+        return false;
+    }
+};
+
+#if defined(__linux__)
+
+/**
+   an allocator which maps anonymous pages for every allocation, 
+   and grows them with mremap(), so the kernel moves page table entries instead of bytes.
+   it is meant for very big buffers, every allocation takes at least one page
+**/
+template <typename T>
+class mmap_allocator
+{
+public:
+    using value_type = T;
+
+    mmap_allocator() noexcept = default;
+
+    template <typename U>
+    mmap_allocator( const mmap_allocator<U> & ) noexcept
+    {
+    }
+
+    T *allocate( std::size_t n )
+    {
+        auto ptr = ::mmap( nullptr, mapping_size( n ), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0 );
+        if( ptr == MAP_FAILED )
+        {
+            throw std::bad_alloc();
+        }
+        return static_cast<T *>( ptr );
+    }
+
+    void deallocate( T *ptr, std::size_t n ) noexcept
+    {
+        ::munmap( ptr, mapping_size( n ) );
+    }
+
+    T *reallocate( T *ptr, std::size_t old_n, std::size_t new_n )
+    {
+        auto new_ptr = ::mremap( ptr, mapping_size( old_n ), mapping_size( new_n ), MREMAP_MAYMOVE );
+        if( new_ptr == MAP_FAILED )
+        {
+            throw std::bad_alloc();
+        }
+        return static_cast<T *>( new_ptr );
+    }
+
+    template <typename U>
+    bool operator==( const mmap_allocator<U> & ) const noexcept
+    {
+        return true;
+    }
+
+    template <typename U>
+    bool operator!=( const mmap_allocator<U> & ) const noexcept
+    {
+        return false;
+    }
+
+private:
+    // bytes of the mapping which holds n objects, rounded up to whole pages
+    static std::size_t mapping_size( std::size_t n )
+    {
+        static const std::size_t page_size = static_cast<std::size_t>( ::sysconf( _SC_PAGESIZE ) );
+
+        if( n > ( std::numeric_limits<std::size_t>::max() - page_size ) / sizeof( T ) )
+        {
+            throw std::bad_alloc();
+        }
+        auto bytes = n == 0 ? page_size : n * sizeof( T );
+        return ( bytes + page_size - 1 ) / page_size * page_size;
+    }
+};
+
+#endif /* __linux__ */
+
+};    // namespace mystl
+
 #endif /* _MEMORY_H_ */
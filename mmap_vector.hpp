@@ -0,0 +1,330 @@
+/***
+    mmap_vector
+        1. 元素存放在内存映射的文件中，打开文件即可使用其中的元素，无需读取和解析
+        2. 通过 ftruncate 和 mremap 扩展容量，扩展时不复制元素
+        3. 接口与 vector 相同，由 vector 派生而来，只支持 trivially copyable 的元素
+        4. 文件开头的 mmap_file_header 记录元素个数，sync() 之后进程崩溃也能恢复
+        5. 依赖 Linux 的 mremap()
+
+    版本 1.0
+ ***/
+
+#ifndef _MMAP_VECTOR_H_
+#define _MMAP_VECTOR_H_
+
+#include "vector.hpp"
+#include <string>
+#include <limits>
+#include <cstdint>
+#include <cstring>
+#include <cerrno>
+#include <cstddef>
+#include <system_error>
+#include <type_traits>
+
+#if !defined(__linux__)
+#error "mmap_vector.hpp requires mremap(), which is only available on Linux"
+#endif
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace mystl {
+
+/**
+   the first bytes of an mmap_vector file, the elements start at SIZE.
+   the file is usually longer than the elements, size is the number of elements
+   written when the file was last synced
+**/
+struct mmap_file_header
+{
+    static const std::size_t SIZE = 64;
+
+    char           magic[8];
+    std::uint64_t  element_size;        // sizeof( T ), so a wrong T is detected
+    std::uint64_t  size;
+
+    static const char *signature() noexcept
+    {
+        return "MYSTLMVC";
+    }
+};
+
+/**
+   maps the file fd into memory, the file is extended with ftruncate() before the mapping grows.
+   without a file ( fd is -1 ) it maps anonymous memory, as copies of the allocator do.
+   every mapping starts with an mmap_file_header, the objects follow it
+**/
+template <typename T>
+class mapped_file_allocator
+{
+    static_assert(alignof(T) <= mmap_file_header::SIZE, "mapped_file_allocator - T is over-aligned");
+
+public:
+    using value_type = T;
+
+    explicit mapped_file_allocator(int fd = -1) noexcept
+        : fd_(fd)
+    {
+    }
+
+    template <typename U>
+    mapped_file_allocator(const mapped_file_allocator<U> &other) noexcept
+        : fd_(other.fd())
+    {
+    }
+
+    // a copy of a file-backed container must not write into the same file
+    mapped_file_allocator select_on_container_copy_construction() const noexcept
+    {
+        return mapped_file_allocator();
+    }
+
+    T *allocate(std::size_t n)
+    {
+        const auto bytes = mapping_size(n);
+        if (fd_ >= 0 && ::ftruncate(fd_, static_cast<off_t>(bytes)) != 0)
+        {
+            throw std::bad_alloc();
+        }
+
+        auto ptr = fd_ >= 0 ? ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0)
+                            : ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (ptr == MAP_FAILED)
+        {
+            throw std::bad_alloc();
+        }
+
+        auto header = static_cast<mmap_file_header *>(ptr);
+        std::memcpy(header->magic, mmap_file_header::signature(), sizeof(header->magic));
+        header->element_size = sizeof(T);
+        header->size = 0;
+        return objects(ptr);
+    }
+
+    void deallocate(T *ptr, std::size_t n) noexcept
+    {
+        if (ptr)
+        {
+            ::munmap(header(ptr), mapping_size(n));
+        }
+    }
+
+    // the file is extended before the mapping grows, and truncated after the mapping shrinks
+    T *reallocate(T *ptr, std::size_t old_n, std::size_t new_n)
+    {
+        const auto old_bytes = mapping_size(old_n);
+        const auto new_bytes = mapping_size(new_n);
+        if (fd_ >= 0 && new_bytes > old_bytes && ::ftruncate(fd_, static_cast<off_t>(new_bytes)) != 0)
+        {
+            throw std::bad_alloc();
+        }
+
+        auto new_ptr = ::mremap(header(ptr), old_bytes, new_bytes, MREMAP_MAYMOVE);
+        if (new_ptr == MAP_FAILED)
+        {
+            throw std::bad_alloc();
+        }
+
+        if (fd_ >= 0 && new_bytes < old_bytes)
+        {
+            ::ftruncate(fd_, static_cast<off_t>(new_bytes));
+        }
+        return objects(new_ptr);
+    }
+
+    int fd() const noexcept
+    {
+        return fd_;
+    }
+
+    // bytes of the mapping which holds the header and n objects, rounded up to whole pages
+    static std::size_t mapping_size(std::size_t n)
+    {
+        static const std::size_t page_size = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+
+        if (n > (std::numeric_limits<std::size_t>::max() - page_size - mmap_file_header::SIZE) / sizeof(T))
+        {
+            throw std::bad_alloc();
+        }
+        auto bytes = mmap_file_header::SIZE + n * sizeof(T);
+        return (bytes + page_size - 1) / page_size * page_size;
+    }
+
+    // the header in front of the objects at ptr
+    static mmap_file_header *header(T *ptr) noexcept
+    {
+        return reinterpret_cast<mmap_file_header *>(reinterpret_cast<char *>(ptr) - mmap_file_header::SIZE);
+    }
+
+    // the objects behind the header of the mapping at ptr
+    static T *objects(void *ptr) noexcept
+    {
+        return reinterpret_cast<T *>(static_cast<char *>(ptr) + mmap_file_header::SIZE);
+    }
+
+    template <typename U>
+    bool operator==(const mapped_file_allocator<U> &other) const noexcept
+    {
+        return fd_ == other.fd();
+    }
+
+    template <typename U>
+    bool operator!=(const mapped_file_allocator<U> &other) const noexcept
+    {
+        return !(*this == other);
+    }
+
+private:
+    int fd_;
+};
+
+/**
+   a vector whose elements live in a file, opening the file maps the elements written
+   by an earlier run without reading them, the kernel pages them in and out on demand.
+   the file keeps the spare capacity, sync() records size() in the header, and when
+   the mmap_vector is destroyed the file is truncated to exactly size() elements.
+
+   the file holds the raw bytes of the elements, so it is only readable by
+   a program with the same T layout
+**/
+template <typename T, typename GrowthPolicy = double_growth>
+class mmap_vector : public vector<T, mapped_file_allocator<T>, GrowthPolicy>
+{
+    static_assert(std::is_trivially_copyable<T>::value, "mmap_vector - T must be trivially copyable");
+
+    using base_type = vector<T, mapped_file_allocator<T>, GrowthPolicy>;
+
+public:
+    using typename base_type::value_type;
+    using typename base_type::size_type;
+
+    /**
+       opens the file at path, creates it if it doesn't exist.
+       throw std::system_error if the file can't be opened or mapped,
+       or if it isn't an mmap_vector file of T
+    **/
+    explicit mmap_vector(const std::string &path)
+        : base_type(mapped_file_allocator<T>(open_file(path)))
+    {
+        try
+        {
+            map_file();
+        }
+        catch(...)
+        {
+            ::close(this->alloc_.fd());
+            throw;
+        }
+    }
+
+    mmap_vector(const mmap_vector &) = delete;
+    mmap_vector &operator=(const mmap_vector &) = delete;
+
+    ~mmap_vector() noexcept
+    {
+        if (this->elem_)
+        {
+            mapped_file_allocator<T>::header(this->elem_)->size = this->size();
+            ::ftruncate(this->alloc_.fd(), static_cast<off_t>(mmap_file_header::SIZE + this->size() * sizeof(value_type)));
+        }
+        else
+        {
+            ::ftruncate(this->alloc_.fd(), 0);    // an empty file is an empty vector
+        }
+        ::close(this->alloc_.fd());
+    }
+
+    /**
+       writes the elements and their number back to the file, and waits until it is done.
+       if the process dies later, the file reopens with the elements of the last sync()
+    **/
+    void sync()
+    {
+        if (!this->elem_)
+        {
+            if (::ftruncate(this->alloc_.fd(), 0) != 0 || ::fsync(this->alloc_.fd()) != 0)
+            {
+                throw std::system_error(errno, std::generic_category(), "mmap_vector::sync() - can't empty the file");
+            }
+            return;
+        }
+
+        auto header = mapped_file_allocator<T>::header(this->elem_);
+        header->size = this->size();
+        if (::msync(header, mmap_file_header::SIZE + this->size() * sizeof(value_type), MS_SYNC) != 0)
+        {
+            throw std::system_error(errno, std::generic_category(), "mmap_vector::sync() - msync() failed");
+        }
+    }
+
+private:
+    static int open_file(const std::string &path)
+    {
+        const int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+        if (fd < 0)
+        {
+            throw std::system_error(errno, std::generic_category(), "mmap_vector - can't open " + path);
+        }
+        return fd;
+    }
+
+    /**
+       maps the elements already in the file, the bytes after the last whole element
+       are left alone, and the elements after the recorded size become spare capacity
+    **/
+    void map_file()
+    {
+        const int fd = this->alloc_.fd();
+        struct stat status;
+        if (::fstat(fd, &status) != 0)
+        {
+            throw std::system_error(errno, std::generic_category(), "mmap_vector - fstat() failed");
+        }
+
+        const auto bytes = static_cast<size_type>(status.st_size);
+        if (bytes == 0)
+        {
+            return;
+        }
+
+        mmap_file_header header;
+        if (bytes < mmap_file_header::SIZE || ::pread(fd, &header, sizeof(header), 0) != static_cast<ssize_t>(sizeof(header))
+            || std::memcmp(header.magic, mmap_file_header::signature(), sizeof(header.magic)) != 0)
+        {
+            throw std::system_error(EINVAL, std::generic_category(), "mmap_vector - not an mmap_vector file");
+        }
+        if (header.element_size != sizeof(value_type))
+        {
+            throw std::system_error(EINVAL, std::generic_category(), "mmap_vector - the file holds elements of another size");
+        }
+
+        const size_type n = (bytes - mmap_file_header::SIZE) / sizeof(value_type);
+        if (header.size > n)
+        {
+            throw std::system_error(EINVAL, std::generic_category(), "mmap_vector - the file is truncated");
+        }
+        if (n == 0)
+        {
+            return;
+        }
+
+        auto ptr = ::mmap(nullptr, mapped_file_allocator<T>::mapping_size(n), PROT_READ | PROT_WRITE,
+                          MAP_SHARED, fd, 0);
+        if (ptr == MAP_FAILED)
+        {
+            throw std::system_error(errno, std::generic_category(), "mmap_vector - mmap() failed");
+        }
+        this->elem_ = mapped_file_allocator<T>::objects(ptr);
+        this->free_ = this->elem_ + static_cast<size_type>(header.size);
+        this->last_ = this->elem_ + n;
+    }
+};
+
+
+}; // namespace mystl
+
+
+#endif /* _MMAP_VECTOR_H_ */
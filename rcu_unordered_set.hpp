@@ -0,0 +1,567 @@
+/***
+    读多写少的并发散列表
+        1. 读操作不加锁，也不执行任何原子读-改-写操作，读线程之间互不干扰
+        2. 写操作由互斥锁串行化，新节点和新的桶数组写好之后再发布给读线程
+        3. 被删除的节点和旧的桶数组在所有读线程离开之后才释放（基于 epoch 的回收）
+        4. 桶数与 unordered_set 相同，为素数
+
+    版本 1.0
+ ***/
+
+#ifndef _RCU_UNORDERED_SET_H_
+#define _RCU_UNORDERED_SET_H_
+
+#include "hash_policy.hpp"
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <utility>
+#include <functional>
+#include <initializer_list>
+
+namespace mystl {
+
+/**
+   epoch based reclamation for the read-mostly containers. a reader publishes the current epoch
+   while it is inside a read section, and 0 outside. a writer first unlinks an object, then calls
+   synchronize(), which advances the epoch and waits until no reader is still in an older epoch,
+   after that no reader can reach the object and it can be freed.
+
+   entering a read section costs a store and a fence, but no lock and no read-modify-write.
+   every reader takes a whole cache line, so readers never write to a cache line shared with other threads
+**/
+class epoch_domain
+{
+public:
+    static const std::size_t CACHE_LINE_SIZE = 64;
+
+    struct alignas( CACHE_LINE_SIZE ) reader
+    {
+        std::atomic<std::uint64_t>  epoch_{ 0 };       // the epoch the thread reads in, 0 outside read sections
+        unsigned                    nesting_ = 0;      // only touched by the owner thread
+        bool                        in_use_ = true;    // guarded by the mutex of the domain
+        reader                     *next_ = nullptr;
+    };
+
+    // the domain shared by all containers, it's never destroyed so threads may exit in any order
+    static epoch_domain &instance()
+    {
+        static epoch_domain *domain = new epoch_domain;
+        return *domain;
+    }
+
+    // the reader of the calling thread, registered on first use and released when the thread exits
+    static reader &current_reader()
+    {
+        thread_local reader_handle handle( instance() );
+        return *handle.reader_;
+    }
+
+    // read sections may nest
+    void enter( reader &r ) noexcept
+    {
+        if( r.nesting_++ == 0 )
+        {
+            r.epoch_.store( epoch_.load( std::memory_order_relaxed ), std::memory_order_relaxed );
+            // the store above must be visible before the reader loads any shared pointer
+            std::atomic_thread_fence( std::memory_order_seq_cst );
+        }
+    }
+
+    void leave( reader &r ) noexcept
+    {
+        if( --r.nesting_ == 0 )
+        {
+            r.epoch_.store( 0, std::memory_order_release );
+        }
+    }
+
+    /**
+       waits until every read section which started before the call has ended,
+       it must not be called inside a read section of the calling thread
+    **/
+    void synchronize()
+    {
+        std::lock_guard<std::mutex> lock( mutex_ );
+
+        std::atomic_thread_fence( std::memory_order_seq_cst );
+        const std::uint64_t target = epoch_.load( std::memory_order_relaxed ) + 1;
+        epoch_.store( target, std::memory_order_relaxed );
+        std::atomic_thread_fence( std::memory_order_seq_cst );
+
+        for( auto r = readers_; r != nullptr; r = r->next_ )
+        {
+            for( ; ; )
+            {
+                const auto epoch = r->epoch_.load( std::memory_order_acquire );
+                if( epoch == 0 || epoch >= target )
+                {
+                    break;
+                }
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    // RAII read section
+    class guard
+    {
+    public:
+        guard()
+            : domain_( instance() ), reader_( current_reader() )
+        {
+            domain_.enter( reader_ );
+        }
+
+        ~guard()
+        {
+            domain_.leave( reader_ );
+        }
+
+        guard( const guard & ) = delete;
+        guard &operator=( const guard & ) = delete;
+
+    private:
+        epoch_domain &domain_;
+        reader       &reader_;
+    };
+
+private:
+    struct reader_handle
+    {
+        explicit reader_handle( epoch_domain &domain )
+            : domain_( domain ), reader_( domain.acquire_reader() )
+        {
+        }
+
+        ~reader_handle()
+        {
+            domain_.release_reader( reader_ );
+        }
+
+        epoch_domain &domain_;
+        reader       *reader_;
+    };
+
+    epoch_domain() = default;
+
+    // the readers of exited threads are reused, they are never freed
+    reader *acquire_reader()
+    {
+        std::lock_guard<std::mutex> lock( mutex_ );
+        for( auto r = readers_; r != nullptr; r = r->next_ )
+        {
+            if( !r->in_use_ )
+            {
+                r->in_use_ = true;
+                return r;
+            }
+        }
+        // operator new doesn't promise the alignment of reader before C++17, so the memory is aligned by hand.
+        // the readers are never freed, so the unaligned pointer isn't kept
+        std::size_t space = sizeof( reader ) + CACHE_LINE_SIZE;
+        void *memory = ::operator new( space );
+        auto r = ::new ( std::align( CACHE_LINE_SIZE, sizeof( reader ), memory, space ) ) reader;
+        r->next_ = readers_;
+        readers_ = r;
+        return r;
+    }
+
+    void release_reader( reader *r )
+    {
+        std::lock_guard<std::mutex> lock( mutex_ );
+        r->epoch_.store( 0, std::memory_order_release );
+        r->nesting_ = 0;
+        r->in_use_ = false;
+    }
+
+    std::atomic<std::uint64_t>  epoch_{ 1 };
+    std::mutex                  mutex_;                // serializes synchronize() and guards readers_
+    reader                     *readers_ = nullptr;
+};
+
+/**
+   a hash set for data which is read far more often than written, such as a configuration or a blocklist.
+   contains(), find() and for_each() take no lock, they only read the buckets which the writers publish.
+   insert(), erase(), rehash() and clear() are serialized by a mutex: they publish new nodes with release stores,
+   grow by publishing a new bucket array with copies of the elements, and free the unlinked nodes
+   and bucket arrays only after the readers which may still see them are gone.
+
+   the elements are never modified in place, so T must be copyable to rehash
+**/
+template <typename T, typename Hash = std::hash<T>, typename Equal = std::equal_to<T>>
+class rcu_unordered_set
+{
+public:
+    using key_type              = T;
+    using value_type            = T;
+    using hasher                = Hash;
+    using key_equal             = Equal;
+    using size_type             = std::size_t;
+
+private:
+    struct node
+    {
+        template <typename... Args>
+        explicit node( size_type hash, Args&&... args )
+            : value_( std::forward<Args>( args )... ), hash_( hash ), next_( nullptr )
+        {
+        }
+
+        const T             value_;
+        const size_type     hash_;
+        std::atomic<node *> next_;
+    };
+
+    struct table
+    {
+        explicit table( size_type bucket_count )
+            : bucket_count_( bucket_count ), buckets_( new std::atomic<node *>[bucket_count] )
+        {
+            for( size_type i = 0; i < bucket_count_; ++i )
+            {
+                buckets_[i].store( nullptr, std::memory_order_relaxed );
+            }
+        }
+
+        // frees the nodes too, only when no reader can see the table
+        ~table()
+        {
+            for( size_type i = 0; i < bucket_count_; ++i )
+            {
+                auto ptr = buckets_[i].load( std::memory_order_relaxed );
+                while( ptr != nullptr )
+                {
+                    auto next = ptr->next_.load( std::memory_order_relaxed );
+                    delete ptr;
+                    ptr = next;
+                }
+            }
+        }
+
+        std::atomic<node *> &bucket( size_type hash ) const noexcept
+        {
+            return buckets_[prime_bucket_policy::bucket_index( hash, bucket_count_ )];
+        }
+
+        const size_type                         bucket_count_;
+        std::unique_ptr<std::atomic<node *>[]>  buckets_;
+    };
+
+    // number of erased nodes kept before the writer waits for the readers and frees them
+    static const size_type RECLAIM_THRESHOLD = 64;
+
+    hasher                  hash_;
+    key_equal               equal_;
+    std::atomic<table *>    table_;
+    std::atomic<size_type>  size_{ 0 };
+    std::atomic<float>      max_load_factor_{ 1.0 };  // written under write_mutex_, read by anyone
+    std::mutex              write_mutex_;             // serializes the writers
+    std::vector<node *>     retired_;                 // unlinked nodes not yet freed
+
+public:
+    explicit rcu_unordered_set( size_type bucket_num = 0, const hasher &hash = hasher(), const key_equal &equal = key_equal() )
+        : hash_( hash ),
+          equal_( equal ),
+          table_( new table( prime_bucket_policy::next_bucket_count( bucket_num ) ) )
+    {
+    }
+
+    rcu_unordered_set( std::initializer_list<value_type> lst, size_type bucket_num = 0,
+                       const hasher &hash = hasher(), const key_equal &equal = key_equal() )
+        : rcu_unordered_set( bucket_num, hash, equal )
+    {
+        for( const auto &elem : lst )
+        {
+            insert( elem );
+        }
+    }
+
+    rcu_unordered_set( const rcu_unordered_set & ) = delete;
+    rcu_unordered_set &operator=( const rcu_unordered_set & ) = delete;
+
+    // no reader may use the set any more
+    ~rcu_unordered_set()
+    {
+        free_retired();
+        delete table_.load( std::memory_order_relaxed );
+    }
+
+    size_type size() const noexcept
+    {
+        return size_.load( std::memory_order_relaxed );
+    }
+
+    bool empty() const noexcept
+    {
+        return size() == 0;
+    }
+
+    size_type bucket_count() const
+    {
+        epoch_domain::guard guard;
+        return table_.load( std::memory_order_acquire )->bucket_count_;
+    }
+
+    size_type max_bucket_count() const noexcept
+    {
+        return prime_bucket_policy::max_bucket_count();
+    }
+
+    float load_factor() const
+    {
+        return static_cast<float>( size() ) / bucket_count();
+    }
+
+    float max_load_factor() const noexcept
+    {
+        return max_load_factor_.load( std::memory_order_relaxed );
+    }
+
+    void max_load_factor( float factor )
+    {
+        std::lock_guard<std::mutex> lock( write_mutex_ );
+        max_load_factor_.store( factor, std::memory_order_relaxed );
+    }
+
+    hasher hash_function() const
+    {
+        return hash_;
+    }
+
+    key_equal key_eq() const
+    {
+        return equal_;
+    }
+
+    bool contains( const value_type &value ) const
+    {
+        return find( value, []( const value_type & ) {} );
+    }
+
+    size_type count( const value_type &value ) const
+    {
+        return contains( value ) ? 1 : 0;
+    }
+
+    /**
+       calls func( elem ) if an element equals to value, returns whether it exists.
+       func runs inside the read section, the element must not be used after it returns
+    **/
+    template <typename Function>
+    bool find( const value_type &value, Function func ) const
+    {
+        const size_type hash = hash_( value );
+        epoch_domain::guard guard;
+
+        const table *tab = table_.load( std::memory_order_acquire );
+        for( auto ptr = tab->bucket( hash ).load( std::memory_order_acquire ); ptr != nullptr;
+             ptr = ptr->next_.load( std::memory_order_acquire ) )
+        {
+            if( ptr->hash_ == hash && equal_( ptr->value_, value ) )
+            {
+                func( ptr->value_ );
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+       calls func( elem ) for the elements inside one read section, every element which is
+       in the set during the whole call is visited once, the elements inserted or erased meanwhile may not
+    **/
+    template <typename Function>
+    void for_each( Function func ) const
+    {
+        epoch_domain::guard guard;
+
+        const table *tab = table_.load( std::memory_order_acquire );
+        for( size_type i = 0; i < tab->bucket_count_; ++i )
+        {
+            for( auto ptr = tab->buckets_[i].load( std::memory_order_acquire ); ptr != nullptr;
+                 ptr = ptr->next_.load( std::memory_order_acquire ) )
+            {
+                func( ptr->value_ );
+            }
+        }
+    }
+
+    /**
+       returns true if value was inserted, false if it was already in the set.
+       growing the table waits for the readers of the old one, so insert() must not be called inside find() or for_each()
+    **/
+    bool insert( const value_type &value )
+    {
+        return emplace_hashed( hash_( value ), value );
+    }
+
+    bool insert( value_type &&value )
+    {
+        const size_type hash = hash_( value );
+        return emplace_hashed( hash, std::move( value ) );
+    }
+
+    // like insert(), it must not be called inside find() or for_each()
+    template <typename... Args>
+    bool emplace( Args&&... args )
+    {
+        return insert( value_type( std::forward<Args>( args )... ) );
+    }
+
+    /**
+       returns the number of elements erased, 0 or 1. every RECLAIM_THRESHOLD erasures it waits
+       for the readers to free the erased elements, so it must not be called inside find() or for_each()
+    **/
+    size_type erase( const value_type &value )
+    {
+        const size_type hash = hash_( value );
+        std::lock_guard<std::mutex> lock( write_mutex_ );
+
+        // only the writers modify the links, and they hold the mutex
+        auto link = &table_.load( std::memory_order_relaxed )->bucket( hash );
+        for( auto ptr = link->load( std::memory_order_relaxed ); ptr != nullptr; ptr = link->load( std::memory_order_relaxed ) )
+        {
+            if( ptr->hash_ == hash && equal_( ptr->value_, value ) )
+            {
+                // readers standing on ptr still reach the rest of the chain through ptr->next_
+                link->store( ptr->next_.load( std::memory_order_relaxed ), std::memory_order_release );
+                size_.store( size() - 1, std::memory_order_relaxed );
+                retire( ptr );
+                return 1;
+            }
+            link = &ptr->next_;
+        }
+        return 0;
+    }
+
+    // waits for the readers of the old elements, so it must not be called inside find() or for_each()
+    void clear()
+    {
+        std::lock_guard<std::mutex> lock( write_mutex_ );
+        auto old = table_.load( std::memory_order_relaxed );
+        table_.store( new table( old->bucket_count_ ), std::memory_order_release );
+        size_.store( 0, std::memory_order_relaxed );
+
+        epoch_domain::instance().synchronize();
+        delete old;
+        free_retired();
+    }
+
+    // waits for the readers of the old table, so it must not be called inside find() or for_each()
+    void rehash( size_type size_hint )
+    {
+        std::lock_guard<std::mutex> lock( write_mutex_ );
+        rehash_table( size_hint );
+    }
+
+    // may rehash, so it must not be called inside find() or for_each() either
+    void reserve( size_type elem_num )
+    {
+        std::lock_guard<std::mutex> lock( write_mutex_ );
+        rehash_table( static_cast<size_type>( elem_num / max_load_factor() ) + 1 );
+    }
+
+    /**
+       frees the erased elements now, instead of when enough of them are erased.
+       it waits for the readers, so it must not be called inside find() or for_each()
+    **/
+    void reclaim()
+    {
+        std::lock_guard<std::mutex> lock( write_mutex_ );
+        epoch_domain::instance().synchronize();
+        free_retired();
+    }
+
+private:
+    template <typename Value>
+    bool emplace_hashed( size_type hash, Value &&value )
+    {
+        std::lock_guard<std::mutex> lock( write_mutex_ );
+        auto tab = table_.load( std::memory_order_relaxed );
+        for( auto ptr = tab->bucket( hash ).load( std::memory_order_relaxed ); ptr != nullptr;
+             ptr = ptr->next_.load( std::memory_order_relaxed ) )
+        {
+            if( ptr->hash_ == hash && equal_( ptr->value_, value ) )
+            {
+                return false;
+            }
+        }
+
+        if( size() + 1 > tab->bucket_count_ * max_load_factor() )
+        {
+            rehash_table( tab->bucket_count_ + 1 );
+            tab = table_.load( std::memory_order_relaxed );
+        }
+
+        // the node is complete before the release store makes it visible
+        auto &head = tab->bucket( hash );
+        auto ptr = new node( hash, std::forward<Value>( value ) );
+        ptr->next_.store( head.load( std::memory_order_relaxed ), std::memory_order_relaxed );
+        head.store( ptr, std::memory_order_release );
+        size_.store( size() + 1, std::memory_order_relaxed );
+        return true;
+    }
+
+    /**
+       the nodes are shared by the chains of one table, so they can't be relinked while readers walk the old table,
+       the new table gets copies of the elements instead, and the old one is freed after the readers leave it
+    **/
+    void rehash_table( size_type size_hint )
+    {
+        auto old = table_.load( std::memory_order_relaxed );
+        const size_type new_bucket_count = prime_bucket_policy::next_bucket_count( size_hint );
+        if( new_bucket_count <= old->bucket_count_ )
+        {
+            return;
+        }
+
+        std::unique_ptr<table> tab( new table( new_bucket_count ) );
+        for( size_type i = 0; i < old->bucket_count_; ++i )
+        {
+            for( auto ptr = old->buckets_[i].load( std::memory_order_relaxed ); ptr != nullptr;
+                 ptr = ptr->next_.load( std::memory_order_relaxed ) )
+            {
+                auto &head = tab->bucket( ptr->hash_ );
+                auto copy = new node( ptr->hash_, ptr->value_ );
+                copy->next_.store( head.load( std::memory_order_relaxed ), std::memory_order_relaxed );
+                head.store( copy, std::memory_order_relaxed );
+            }
+        }
+
+        table_.store( tab.release(), std::memory_order_release );
+        epoch_domain::instance().synchronize();
+        delete old;
+        free_retired();
+    }
+
+    void retire( node *ptr )
+    {
+        retired_.push_back( ptr );
+        if( retired_.size() >= RECLAIM_THRESHOLD )
+        {
+            epoch_domain::instance().synchronize();
+            free_retired();
+        }
+    }
+
+    // the caller must have waited for the readers
+    void free_retired() noexcept
+    {
+        for( auto ptr : retired_ )
+        {
+            delete ptr;
+        }
+        retired_.clear();
+    }
+};
+
+
+};    // namespace mystl
+
+
+#endif /* _RCU_UNORDERED_SET_H_ */
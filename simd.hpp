@@ -0,0 +1,371 @@
+/***
+    SIMD 算法内核
+        1. 对连续存放的算术类型元素，用 SSE2 / AVX2 一次比较多个元素
+        2. 提供 find、count、mismatch，algorithm.hpp 在迭代器为指针时自动使用
+        3. 运行时检测 CPU 是否支持 AVX2，其他平台使用普通的循环，结果与普通循环相同
+
+    版本 1.0
+ ***/
+
+#ifndef _SIMD_H_
+#define _SIMD_H_
+
+#include <cstddef>
+#include <type_traits>
+
+#if ( defined( __x86_64__ ) || defined( __i386__ ) ) && defined( __SSE2__ ) && defined( __GNUC__ )
+#define MYSTL_SIMD_X86 1
+#include <immintrin.h>
+#endif
+
+/**
+   vectorized kernels for searching and comparing contiguous ranges of arithmetic types,
+   algorithm.hpp picks them automatically when the iterators are pointers.
+
+   on x86 the AVX2 kernels are chosen at runtime if the CPU supports them, otherwise the SSE2 kernels,
+   other platforms use the scalar loops. the results are the same as the scalar loops,
+   e.g. a NaN never equals anything
+**/
+
+namespace mystl {
+
+namespace simd {
+
+// arithmetic types which the kernels handle, bool is excluded because any non-zero byte may be true
+template <typename T>
+struct is_vectorizable
+    : std::integral_constant<bool, std::is_arithmetic<T>::value &&
+                                   !std::is_same<T, bool>::value &&
+                                   !std::is_same<T, long double>::value &&
+                                   sizeof( T ) <= 8>
+{
+};
+
+template <typename T>
+inline const T *find_scalar( const T *first, const T *last, const T &value )
+{
+    for( ; first != last && *first != value; ++first )
+    {
+    }
+    return first;
+}
+
+template <typename T>
+inline std::ptrdiff_t count_scalar( const T *first, const T *last, const T &value )
+{
+    std::ptrdiff_t num = 0;
+    for( ; first != last; ++first )
+    {
+        if( *first == value )
+        {
+            ++num;
+        }
+    }
+    return num;
+}
+
+template <typename T>
+inline const T *mismatch_scalar( const T *first1, const T *last1, const T *first2 )
+{
+    for( ; first1 != last1 && *first1 == *first2; ++first1, ++first2 )
+    {
+    }
+    return first1;
+}
+
+#if defined( MYSTL_SIMD_X86 )
+
+inline bool cpu_has_avx2() noexcept
+{
+    static const bool result = ( __builtin_cpu_init(), __builtin_cpu_supports( "avx2" ) );
+    return result;
+}
+
+// a register with every lane set to value
+template <typename T, typename Register>
+inline Register broadcast( const T &value )
+{
+    union
+    {
+        T        lanes_[sizeof( Register ) / sizeof( T )];
+        Register register_;
+    } result;
+
+    for( auto &lane : result.lanes_ )
+    {
+        lane = value;
+    }
+    return result.register_;
+}
+
+/**
+   compares the lanes of T for equality,
+   every byte of an equal lane is set to 0xFF and every byte of an unequal lane is set to 0
+**/
+template <typename T, bool = std::is_floating_point<T>::value, std::size_t = sizeof( T )>
+struct sse2_equal;
+
+template <typename T>
+struct sse2_equal<T, false, 1>
+{
+    static __m128i apply( __m128i left, __m128i right )
+    {
+        return _mm_cmpeq_epi8( left, right );
+    }
+};
+
+template <typename T>
+struct sse2_equal<T, false, 2>
+{
+    static __m128i apply( __m128i left, __m128i right )
+    {
+        return _mm_cmpeq_epi16( left, right );
+    }
+};
+
+template <typename T>
+struct sse2_equal<T, false, 4>
+{
+    static __m128i apply( __m128i left, __m128i right )
+    {
+        return _mm_cmpeq_epi32( left, right );
+    }
+};
+
+// SSE2 has no 64-bit comparison, both 32-bit halves must be equal
+template <typename T>
+struct sse2_equal<T, false, 8>
+{
+    static __m128i apply( __m128i left, __m128i right )
+    {
+        auto equal = _mm_cmpeq_epi32( left, right );
+        return _mm_and_si128( equal, _mm_shuffle_epi32( equal, _MM_SHUFFLE( 2, 3, 0, 1 ) ) );
+    }
+};
+
+template <typename T>
+struct sse2_equal<T, true, 4>
+{
+    static __m128i apply( __m128i left, __m128i right )
+    {
+        return _mm_castps_si128( _mm_cmpeq_ps( _mm_castsi128_ps( left ), _mm_castsi128_ps( right ) ) );
+    }
+};
+
+template <typename T>
+struct sse2_equal<T, true, 8>
+{
+    static __m128i apply( __m128i left, __m128i right )
+    {
+        return _mm_castpd_si128( _mm_cmpeq_pd( _mm_castsi128_pd( left ), _mm_castsi128_pd( right ) ) );
+    }
+};
+
+template <typename T, bool = std::is_floating_point<T>::value, std::size_t = sizeof( T )>
+struct avx2_equal;
+
+template <typename T>
+struct avx2_equal<T, false, 1>
+{
+    __attribute__(( target( "avx2" ) )) static __m256i apply( __m256i left, __m256i right )
+    {
+        return _mm256_cmpeq_epi8( left, right );
+    }
+};
+
+template <typename T>
+struct avx2_equal<T, false, 2>
+{
+    __attribute__(( target( "avx2" ) )) static __m256i apply( __m256i left, __m256i right )
+    {
+        return _mm256_cmpeq_epi16( left, right );
+    }
+};
+
+template <typename T>
+struct avx2_equal<T, false, 4>
+{
+    __attribute__(( target( "avx2" ) )) static __m256i apply( __m256i left, __m256i right )
+    {
+        return _mm256_cmpeq_epi32( left, right );
+    }
+};
+
+template <typename T>
+struct avx2_equal<T, false, 8>
+{
+    __attribute__(( target( "avx2" ) )) static __m256i apply( __m256i left, __m256i right )
+    {
+        return _mm256_cmpeq_epi64( left, right );
+    }
+};
+
+template <typename T>
+struct avx2_equal<T, true, 4>
+{
+    __attribute__(( target( "avx2" ) )) static __m256i apply( __m256i left, __m256i right )
+    {
+        return _mm256_castps_si256( _mm256_cmp_ps( _mm256_castsi256_ps( left ), _mm256_castsi256_ps( right ), _CMP_EQ_OQ ) );
+    }
+};
+
+template <typename T>
+struct avx2_equal<T, true, 8>
+{
+    __attribute__(( target( "avx2" ) )) static __m256i apply( __m256i left, __m256i right )
+    {
+        return _mm256_castpd_si256( _mm256_cmp_pd( _mm256_castsi256_pd( left ), _mm256_castsi256_pd( right ), _CMP_EQ_OQ ) );
+    }
+};
+
+/**
+   every kernel handles one register of elements per iteration, and leaves the rest to the scalar loop.
+   a movemask has sizeof( T ) bits for each lane
+**/
+template <typename T>
+const T *find_sse2( const T *first, const T *last, const T &value )
+{
+    constexpr std::ptrdiff_t lanes = sizeof( __m128i ) / sizeof( T );
+    const auto needle = broadcast<T, __m128i>( value );
+
+    for( ; last - first >= lanes; first += lanes )
+    {
+        const auto block = _mm_loadu_si128( reinterpret_cast<const __m128i *>( first ) );
+        const unsigned mask = _mm_movemask_epi8( sse2_equal<T>::apply( block, needle ) );
+        if( mask != 0 )
+        {
+            return first + __builtin_ctz( mask ) / sizeof( T );
+        }
+    }
+    return find_scalar( first, last, value );
+}
+
+template <typename T>
+__attribute__(( target( "avx2" ) ))
+const T *find_avx2( const T *first, const T *last, const T &value )
+{
+    constexpr std::ptrdiff_t lanes = sizeof( __m256i ) / sizeof( T );
+    const auto needle = _mm256_broadcastsi128_si256( broadcast<T, __m128i>( value ) );
+
+    for( ; last - first >= lanes; first += lanes )
+    {
+        const auto block = _mm256_loadu_si256( reinterpret_cast<const __m256i *>( first ) );
+        const unsigned mask = _mm256_movemask_epi8( avx2_equal<T>::apply( block, needle ) );
+        if( mask != 0 )
+        {
+            return first + __builtin_ctz( mask ) / sizeof( T );
+        }
+    }
+    return find_scalar( first, last, value );
+}
+
+template <typename T>
+std::ptrdiff_t count_sse2( const T *first, const T *last, const T &value )
+{
+    constexpr std::ptrdiff_t lanes = sizeof( __m128i ) / sizeof( T );
+    const auto needle = broadcast<T, __m128i>( value );
+
+    std::ptrdiff_t bits = 0;
+    for( ; last - first >= lanes; first += lanes )
+    {
+        const auto block = _mm_loadu_si128( reinterpret_cast<const __m128i *>( first ) );
+        bits += __builtin_popcount( _mm_movemask_epi8( sse2_equal<T>::apply( block, needle ) ) );
+    }
+    return bits / sizeof( T ) + count_scalar( first, last, value );
+}
+
+template <typename T>
+__attribute__(( target( "avx2" ) ))
+std::ptrdiff_t count_avx2( const T *first, const T *last, const T &value )
+{
+    constexpr std::ptrdiff_t lanes = sizeof( __m256i ) / sizeof( T );
+    const auto needle = _mm256_broadcastsi128_si256( broadcast<T, __m128i>( value ) );
+
+    std::ptrdiff_t bits = 0;
+    for( ; last - first >= lanes; first += lanes )
+    {
+        const auto block = _mm256_loadu_si256( reinterpret_cast<const __m256i *>( first ) );
+        bits += __builtin_popcount( static_cast<unsigned>( _mm256_movemask_epi8( avx2_equal<T>::apply( block, needle ) ) ) );
+    }
+    return bits / sizeof( T ) + count_scalar( first, last, value );
+}
+
+template <typename T>
+const T *mismatch_sse2( const T *first1, const T *last1, const T *first2 )
+{
+    constexpr std::ptrdiff_t lanes = sizeof( __m128i ) / sizeof( T );
+    constexpr unsigned all_equal = 0xFFFF;
+
+    for( ; last1 - first1 >= lanes; first1 += lanes, first2 += lanes )
+    {
+        const auto left = _mm_loadu_si128( reinterpret_cast<const __m128i *>( first1 ) );
+        const auto right = _mm_loadu_si128( reinterpret_cast<const __m128i *>( first2 ) );
+        const unsigned mask = _mm_movemask_epi8( sse2_equal<T>::apply( left, right ) );
+        if( mask != all_equal )
+        {
+            return first1 + __builtin_ctz( ~mask ) / sizeof( T );
+        }
+    }
+    return mismatch_scalar( first1, last1, first2 );
+}
+
+template <typename T>
+__attribute__(( target( "avx2" ) ))
+const T *mismatch_avx2( const T *first1, const T *last1, const T *first2 )
+{
+    constexpr std::ptrdiff_t lanes = sizeof( __m256i ) / sizeof( T );
+    constexpr unsigned all_equal = 0xFFFFFFFF;
+
+    for( ; last1 - first1 >= lanes; first1 += lanes, first2 += lanes )
+    {
+        const auto left = _mm256_loadu_si256( reinterpret_cast<const __m256i *>( first1 ) );
+        const auto right = _mm256_loadu_si256( reinterpret_cast<const __m256i *>( first2 ) );
+        const unsigned mask = _mm256_movemask_epi8( avx2_equal<T>::apply( left, right ) );
+        if( mask != all_equal )
+        {
+            return first1 + __builtin_ctz( ~mask ) / sizeof( T );
+        }
+    }
+    return mismatch_scalar( first1, last1, first2 );
+}
+
+#endif /* MYSTL_SIMD_X86 */
+
+// returns the first element in range [first, last) which equals to value, or last if not found
+template <typename T>
+inline const T *find( const T *first, const T *last, const T &value )
+{
+#if defined( MYSTL_SIMD_X86 )
+    return cpu_has_avx2() ? find_avx2( first, last, value ) : find_sse2( first, last, value );
+#else
+    return find_scalar( first, last, value );
+#endif
+}
+
+// returns the number of elements in range [first, last) which equal to value
+template <typename T>
+inline std::ptrdiff_t count( const T *first, const T *last, const T &value )
+{
+#if defined( MYSTL_SIMD_X86 )
+    return cpu_has_avx2() ? count_avx2( first, last, value ) : count_sse2( first, last, value );
+#else
+    return count_scalar( first, last, value );
+#endif
+}
+
+// returns the first element in range [first1, last1) which differs from its counterpart in first2
+template <typename T>
+inline const T *mismatch( const T *first1, const T *last1, const T *first2 )
+{
+#if defined( MYSTL_SIMD_X86 )
+    return cpu_has_avx2() ? mismatch_avx2( first1, last1, first2 ) : mismatch_sse2( first1, last1, first2 );
+#else
+    return mismatch_scalar( first1, last1, first2 );
+#endif
+}
+
+};    // namespace simd
+
+};    // namespace mystl
+
+#endif /* _SIMD_H_ */
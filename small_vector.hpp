@@ -0,0 +1,410 @@
+/***
+    small_vector
+        1. 前 N 个元素存放在对象内部的缓冲区中，超出后才在堆上分配内存
+        2. 接口与 vector 相同，由 vector 派生而来，但不能当作 vector 使用
+        3. 引入异常，对于不合法的操作会抛出异常
+
+    版本 1.0
+ ***/
+
+#ifndef _SMALL_VECTOR_H_
+#define _SMALL_VECTOR_H_
+
+#include "vector.hpp"
+#include "memory.hpp"
+#include <memory>
+#include <cstddef>
+#include <type_traits>
+#include <initializer_list>
+
+namespace mystl {
+
+// the inline buffer of a small_vector
+template <typename T, std::size_t N>
+struct small_buffer_storage
+{
+    typename std::aligned_storage<sizeof(T) * N, alignof(T)>::type buffer_;
+    bool in_use_ = false;
+
+    T *data() noexcept
+    {
+        return reinterpret_cast<T *>(&buffer_);
+    }
+};
+
+/**
+   hands out the inline buffer for any request of at most N objects while the buffer is free,
+   bigger requests go to the upstream allocator
+**/
+template <typename T, std::size_t N, typename Allocator = std::allocator<T>>
+class small_buffer_allocator
+{
+    using upstream_traits = std::allocator_traits<Allocator>;
+
+public:
+    using value_type = T;
+    using storage_type = small_buffer_storage<T, N>;
+
+    small_buffer_allocator(storage_type *storage = nullptr, const Allocator &upstream = Allocator()) noexcept
+        : storage_(storage), upstream_(upstream)
+    {
+    }
+
+    T *allocate(std::size_t n)
+    {
+        if (storage_ && n <= N && !storage_->in_use_)
+        {
+            storage_->in_use_ = true;
+            return storage_->data();
+        }
+        return upstream_traits::allocate(upstream_, n);
+    }
+
+    void deallocate(T *ptr, std::size_t n) noexcept
+    {
+        if (is_inline(ptr))
+        {
+            storage_->in_use_ = false;
+            return;
+        }
+        upstream_traits::deallocate(upstream_, ptr, n);
+    }
+
+    bool is_inline(const T *ptr) const noexcept
+    {
+        return storage_ && ptr == storage_->data();
+    }
+
+    const Allocator &upstream() const noexcept
+    {
+        return upstream_;
+    }
+
+    bool operator==(const small_buffer_allocator &other) const noexcept
+    {
+        return storage_ == other.storage_ && upstream_ == other.upstream_;
+    }
+
+    bool operator!=(const small_buffer_allocator &other) const noexcept
+    {
+        return !(*this == other);
+    }
+
+private:
+    storage_type *storage_;
+    Allocator     upstream_;
+};
+
+/**
+   small_vector holds up to N elements without touching the heap,
+   it has the same interface as vector so replacing one with the other only changes the type.
+
+   the vector base is protected: vector's swap, assignments and move constructor would hand over
+   a pointer into this object's inline buffer, so a small_vector can't be used as a vector.
+
+   note: the storage of the heap-allocated small_vectors is exchanged by move and swap,
+   so copies of Allocator must be able to free each other's memory
+**/
+template <typename T, std::size_t N, typename Allocator = std::allocator<T>, typename GrowthPolicy = double_growth>
+class small_vector
+    : private small_buffer_storage<T, N>,    // must be constructed before the vector
+      protected vector<T, small_buffer_allocator<T, N, Allocator>, GrowthPolicy>
+{
+    static_assert(N > 0, "small_vector - the inline capacity must be greater than zero");
+
+    using storage_type = small_buffer_storage<T, N>;
+    using base_type    = vector<T, small_buffer_allocator<T, N, Allocator>, GrowthPolicy>;
+
+public:
+    using typename base_type::value_type;
+    using typename base_type::pointer;
+    using typename base_type::const_pointer;
+    using typename base_type::reference;
+    using typename base_type::const_reference;
+    using typename base_type::size_type;
+    using typename base_type::difference_type;
+    using typename base_type::allocator_type;
+    using typename base_type::growth_policy;
+    using typename base_type::iterator;
+    using typename base_type::const_iterator;
+    using typename base_type::reverse_iterator;
+    using typename base_type::const_reverse_iterator;
+
+    // the rest of vector's interface, swap, assign, shrink_to_fit and the comparisons are defined below
+    using base_type::begin;
+    using base_type::end;
+    using base_type::rbegin;
+    using base_type::rend;
+    using base_type::cbegin;
+    using base_type::cend;
+    using base_type::crbegin;
+    using base_type::crend;
+    using base_type::size;
+    using base_type::capacity;
+    using base_type::empty;
+    using base_type::reserve;
+    using base_type::resize;
+    using base_type::resize_default_init;
+    using base_type::resize_uninitialized;
+    using base_type::append;
+    using base_type::clear;
+    using base_type::push_back;
+    using base_type::emplace_back;
+    using base_type::pop_back;
+    using base_type::emplace;
+    using base_type::insert;
+    using base_type::erase;
+    using base_type::erase_if;
+    using base_type::erase_unordered;
+    using base_type::erase_indices;
+    using base_type::operator[];
+    using base_type::at;
+    using base_type::front;
+    using base_type::back;
+    using base_type::get_allocator;
+    using base_type::print;
+    using base_type::sort;
+
+    static constexpr size_type inline_capacity = N;
+
+    small_vector()
+        : base_type(make_allocator(Allocator()))
+    {
+        this->reserve(N);
+    }
+
+    explicit small_vector(const Allocator &alloc)
+        : base_type(make_allocator(alloc))
+    {
+        this->reserve(N);
+    }
+
+    explicit small_vector(size_type n, const Allocator &alloc = Allocator())
+        : small_vector(n, value_type(), alloc)
+    {
+    }
+
+    small_vector(size_type n, const value_type &value, const Allocator &alloc = Allocator())
+        : small_vector(alloc)
+    {
+        this->insert(this->end(), n, value);
+    }
+
+    template<typename InputIterator, typename = mystl::RequireInputIterator<InputIterator>>
+    small_vector(InputIterator first, InputIterator last, const Allocator &alloc = Allocator())
+        : small_vector(alloc)
+    {
+        this->insert(this->end(), first, last);
+    }
+
+    small_vector(std::initializer_list<value_type> values, const Allocator &alloc = Allocator())
+        : small_vector(values.begin(), values.end(), alloc)
+    {
+    }
+
+    small_vector(const small_vector &other)
+        : small_vector(other.begin(), other.end(), other.get_allocator().upstream())
+    {
+    }
+
+    small_vector(small_vector &&other) noexcept(std::is_nothrow_move_constructible<value_type>::value)
+        : base_type(make_allocator(other.get_allocator().upstream()))
+    {
+        steal(other);
+    }
+
+    ~small_vector() = default;
+
+    small_vector &operator=(const small_vector &other)
+    {
+        if (this != &other)
+        {
+            assign(other.begin(), other.end());
+        }
+        return *this;
+    }
+
+    small_vector &operator=(small_vector &&other) noexcept(std::is_nothrow_move_constructible<value_type>::value)
+    {
+        if (this != &other)
+        {
+            release_heap();
+            steal(other);
+        }
+        return *this;
+    }
+
+    small_vector &operator=(std::initializer_list<value_type> values)
+    {
+        assign(values.begin(), values.end());
+        return *this;
+    }
+
+    /**
+       unlike vector::assign, the storage is kept, so a small_vector
+       never gives up its inline buffer for a smaller heap buffer
+    **/
+    template<typename InputIterator, typename = mystl::RequireInputIterator<InputIterator>>
+    void assign(InputIterator first, InputIterator last)
+    {
+        this->clear();
+        this->insert(this->end(), first, last);
+    }
+
+    void assign(std::initializer_list<value_type> values)
+    {
+        assign(values.begin(), values.end());
+    }
+
+    void assign(size_type n, const value_type &value)
+    {
+        this->clear();
+        this->insert(this->end(), n, value);
+    }
+
+    // moves the elements back into the inline buffer if they fit
+    void shrink_to_fit()
+    {
+        if (is_inline())
+        {
+            return;
+        }
+        if (this->size() <= N)
+        {
+            // the heap buffer moves to other, this small_vector is left with its empty inline buffer
+            small_vector other(std::move(*this));
+            for (auto &elem : other)
+            {
+                this->emplace_back(std::move(elem));
+            }
+            return;
+        }
+        base_type::shrink_to_fit();
+    }
+
+    // returns true if the elements live in the inline buffer
+    bool is_inline() const noexcept
+    {
+        return this->alloc_.is_inline(this->elem_);
+    }
+
+    void swap(small_vector &other) noexcept(std::is_nothrow_move_constructible<value_type>::value)
+    {
+        if (!is_inline() && !other.is_inline())
+        {
+            // only the heap buffers are exchanged, each allocator keeps pointing to its own inline buffer
+            using std::swap;
+            swap(this->elem_, other.elem_);
+            swap(this->free_, other.free_);
+            swap(this->last_, other.last_);
+            return;
+        }
+        small_vector tmp(std::move(other));
+        other = std::move(*this);
+        *this = std::move(tmp);
+    }
+
+    bool operator==(const small_vector &other) const noexcept
+    {
+        return base() == other.base();
+    }
+
+    bool operator!=(const small_vector &other) const noexcept
+    {
+        return base() != other.base();
+    }
+
+    bool operator<(const small_vector &other) const noexcept
+    {
+        return base() < other.base();
+    }
+
+    bool operator>(const small_vector &other) const noexcept
+    {
+        return base() > other.base();
+    }
+
+    bool operator>=(const small_vector &other) const noexcept
+    {
+        return base() >= other.base();
+    }
+
+    bool operator<=(const small_vector &other) const noexcept
+    {
+        return base() <= other.base();
+    }
+
+private:
+    const base_type &base() const noexcept
+    {
+        return *this;
+    }
+
+    small_buffer_allocator<T, N, Allocator> make_allocator(const Allocator &upstream) noexcept
+    {
+        return { static_cast<storage_type *>(this), upstream };
+    }
+
+    // frees the heap buffer and leaves this small_vector without any storage
+    void release_heap() noexcept
+    {
+        this->clear();
+        if (this->elem_ && !is_inline())
+        {
+            this->alloc_.deallocate(this->elem_, this->capacity());
+            this->elem_ = this->free_ = this->last_ = nullptr;
+        }
+    }
+
+    /**
+       takes over other's elements, this small_vector must have no element.
+       a heap buffer is adopted as a whole, elements in the inline buffer are moved one by one.
+       other is left empty with its inline buffer
+    **/
+    void steal(small_vector &other)
+    {
+        if (other.is_inline())
+        {
+            this->reserve(N);
+            for (auto &elem : other)
+            {
+                this->emplace_back(std::move(elem));
+            }
+            other.clear();
+            return;
+        }
+
+        if (this->elem_)
+        {
+            this->alloc_.deallocate(this->elem_, this->capacity());
+        }
+        this->elem_ = other.elem_;
+        this->free_ = other.free_;
+        this->last_ = other.last_;
+
+        other.elem_ = other.free_ = other.last_ = nullptr;
+        other.reserve(N);
+    }
+};
+
+template <typename T, std::size_t N, typename Allocator, typename GrowthPolicy>
+constexpr typename small_vector<T, N, Allocator, GrowthPolicy>::size_type small_vector<T, N, Allocator, GrowthPolicy>::inline_capacity;
+
+template <typename T, std::size_t N, typename Allocator, typename GrowthPolicy>
+void swap(small_vector<T, N, Allocator, GrowthPolicy> &first, small_vector<T, N, Allocator, GrowthPolicy> &second)
+    noexcept(noexcept(first.swap(second)))
+{
+    first.swap(second);
+}
+
+template <typename T, std::size_t N, typename Allocator, typename GrowthPolicy>
+std::ostream &operator<<(std::ostream &os, const small_vector<T, N, Allocator, GrowthPolicy> &vec)
+{
+    vec.print(os, " ");
+    return os;
+}
+
+}; // namespace mystl
+
+
+#endif /* _SMALL_VECTOR_H_ */
@@ -0,0 +1,604 @@
+/***
+    散列映射
+        1. 以 unordered_set 存放键值对，散列和桶的实现与 unordered_set 相同
+        2. 通过迭代器和 operator[] 可以直接修改值，不需要先删除再插入
+        3. 支持 try_emplace、insert_or_assign 以及透明查找
+        4. 引入异常，对于不合法的操作会抛出异常
+
+    版本 1.0
+ ***/
+
+#ifndef _UNORDERED_MAP_H_
+#define _UNORDERED_MAP_H_
+
+#include "unordered_set.hpp"
+#include "iterator.hpp"
+#include <tuple>
+#include <utility>
+#include <cstddef>
+#include <iterator>
+#include <stdexcept>
+#include <functional>
+#include <type_traits>
+#include <initializer_list>
+
+namespace mystl {
+
+/**
+   the entries are kept in an unordered_set which only hashes and compares their keys,
+   the mapped value is mutable, so it can be changed through the set's const iterators
+   without touching the key or the bucket of the entry
+**/
+template <typename Key, typename T, typename Hash = std::hash<Key>, typename Equal = std::equal_to<Key>,
+          typename BucketPolicy = prime_bucket_policy>
+class unordered_map
+{
+public:
+    using key_type              = Key;
+    using mapped_type           = T;
+    using value_type            = std::pair<const Key, T>;
+    using hasher                = Hash;
+    using key_equal             = Equal;
+    using pointer               = value_type*;
+    using const_pointer         = const value_type*;
+    using reference             = value_type&;
+    using const_reference       = const value_type&;
+    using size_type             = std::size_t;
+    using difference_type       = std::ptrdiff_t;
+
+private:
+    // the tag keeps the constructor from taking over the copy and move constructors
+    struct construct_tag
+    {
+    };
+
+    struct entry
+    {
+        // forward_list needs it for its dummy head
+        entry() = default;
+
+        template <typename... Args>
+        explicit entry( construct_tag, Args&&... args )
+            : value_( std::forward<Args>( args )... )
+        {
+        }
+
+        mutable value_type value_;
+    };
+
+    // hashes an entry by its key, or a key directly
+    struct entry_hash
+    {
+        explicit entry_hash( const hasher &hash = hasher() )
+            : hash_( hash )
+        {
+        }
+
+        std::size_t operator()( const entry &elem ) const
+        {
+            return hash_( elem.value_.first );
+        }
+
+        template <typename K>
+        std::size_t operator()( const K &key ) const
+        {
+            return hash_( key );
+        }
+
+        hasher hash_;
+    };
+
+    // compares an entry with another entry's key, or with a key directly
+    struct entry_equal
+    {
+        explicit entry_equal( const key_equal &equal = key_equal() )
+            : equal_( equal )
+        {
+        }
+
+        bool operator()( const entry &left, const entry &right ) const
+        {
+            return equal_( left.value_.first, right.value_.first );
+        }
+
+        template <typename K>
+        bool operator()( const entry &left, const K &key ) const
+        {
+            return equal_( left.value_.first, key );
+        }
+
+        key_equal equal_;
+    };
+
+    using set_type = unordered_set<entry, entry_hash, entry_equal, cache_hash_code<Key>::value, BucketPolicy>;
+
+public:
+    class const_iterator
+    {
+        friend class unordered_map;
+    public:
+        using value_type        = typename unordered_map::value_type;
+        using pointer           = const value_type*;
+        using reference         = const value_type&;
+        using difference_type   = std::ptrdiff_t;
+        using iterator_category = std::forward_iterator_tag;
+
+        const_iterator() = default;
+
+        reference operator*() const
+        {
+            return iter_->value_;
+        }
+
+        pointer operator->() const
+        {
+            return &( operator*() );
+        }
+
+        const_iterator &operator++() noexcept
+        {
+            ++iter_;
+            return *this;
+        }
+
+        const_iterator operator++(int) noexcept
+        {
+            auto tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        bool operator==( const const_iterator &other ) const noexcept
+        {
+            return iter_ == other.iter_;
+        }
+
+        bool operator!=( const const_iterator &other ) const noexcept
+        {
+            return !( *this == other );
+        }
+
+    protected:
+        explicit const_iterator( typename set_type::const_iterator iter )
+            : iter_( iter )
+        {
+        }
+
+        typename set_type::const_iterator iter_;
+    };
+
+    // the key is still const, only the mapped value can be modified through iterator
+    class iterator : public const_iterator
+    {
+        friend class unordered_map;
+    public:
+        using value_type        = typename unordered_map::value_type;
+        using pointer           = value_type*;
+        using reference         = value_type&;
+        using difference_type   = std::ptrdiff_t;
+        using iterator_category = std::forward_iterator_tag;
+
+        iterator() = default;
+
+        reference operator*() const
+        {
+            return this->iter_->value_;
+        }
+
+        pointer operator->() const
+        {
+            return &( operator*() );
+        }
+
+        iterator &operator++() noexcept
+        {
+            ++this->iter_;
+            return *this;
+        }
+
+        iterator operator++(int) noexcept
+        {
+            auto tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+    protected:
+        explicit iterator( typename set_type::const_iterator iter )
+            : const_iterator( iter )
+        {
+        }
+    };
+
+private:
+    set_type set_;
+
+public:
+    unordered_map() = default;
+
+    explicit unordered_map( size_type bucket_num, const hasher &hash = hasher(), const key_equal &equal = key_equal() )
+        : set_( bucket_num, entry_hash( hash ), entry_equal( equal ) )
+    {
+    }
+
+    template<typename InputIterator, typename = mystl::RequireInputIterator<InputIterator>>
+    unordered_map( InputIterator first, InputIterator last, size_type bucket_num = 0,
+                   const hasher &hash = hasher(), const key_equal &equal = key_equal() )
+        : unordered_map( bucket_num, hash, equal )
+    {
+        insert( first, last );
+    }
+
+    unordered_map( std::initializer_list<value_type> lst, size_type bucket_num = 0,
+                   const hasher &hash = hasher(), const key_equal &equal = key_equal() )
+        : unordered_map( lst.begin(), lst.end(), bucket_num, hash, equal )
+    {
+    }
+
+    unordered_map( const unordered_map &other ) = default;
+    unordered_map( unordered_map &&other ) noexcept = default;
+    unordered_map &operator=( const unordered_map &other ) = default;
+    unordered_map &operator=( unordered_map &&other ) noexcept = default;
+    ~unordered_map() = default;
+
+    unordered_map &operator=( std::initializer_list<value_type> lst )
+    {
+        clear();
+        insert( lst.begin(), lst.end() );
+        return *this;
+    }
+
+    void swap( unordered_map &other ) noexcept
+    {
+        set_.swap( other.set_ );
+    }
+
+    size_type bucket_count() const noexcept
+    {
+        return set_.bucket_count();
+    }
+
+    void rehash( size_type size_hint )
+    {
+        set_.rehash( size_hint );
+    }
+
+    void reserve( size_type elem_num )
+    {
+        set_.reserve( elem_num );
+    }
+
+    // see unordered_set::incremental_rehash()
+    void incremental_rehash( bool enable )
+    {
+        set_.incremental_rehash( enable );
+    }
+
+    bool incremental_rehash() const noexcept
+    {
+        return set_.incremental_rehash();
+    }
+
+    void complete_rehash()
+    {
+        set_.complete_rehash();
+    }
+
+    hash_table_stats stats() const
+    {
+        return set_.stats();
+    }
+
+    float load_factor() const noexcept
+    {
+        return set_.load_factor();
+    }
+
+    float max_load_factor() const noexcept
+    {
+        return set_.max_load_factor();
+    }
+
+    void max_load_factor( float factor )
+    {
+        set_.max_load_factor( factor );
+    }
+
+    void clear() noexcept
+    {
+        set_.clear();
+    }
+
+    bool empty() const noexcept
+    {
+        return set_.empty();
+    }
+
+    size_type size() const noexcept
+    {
+        return set_.size();
+    }
+
+    size_type max_size() const noexcept
+    {
+        return set_.max_size();
+    }
+
+    iterator begin() noexcept
+    {
+        return iterator( set_.begin() );
+    }
+
+    const_iterator begin() const noexcept
+    {
+        return const_iterator( set_.begin() );
+    }
+
+    iterator end() noexcept
+    {
+        return iterator( set_.end() );
+    }
+
+    const_iterator end() const noexcept
+    {
+        return const_iterator( set_.end() );
+    }
+
+    const_iterator cbegin() const noexcept
+    {
+        return begin();
+    }
+
+    const_iterator cend() const noexcept
+    {
+        return end();
+    }
+
+    hasher hash_function() const
+    {
+        return set_.hash_.hash_;
+    }
+
+    key_equal key_eq() const
+    {
+        return set_.equal_.equal_;
+    }
+
+    std::pair<iterator, bool> insert( const value_type &value )
+    {
+        return try_emplace( value.first, value.second );
+    }
+
+    std::pair<iterator, bool> insert( value_type &&value )
+    {
+        return try_emplace( value.first, std::move( value.second ) );
+    }
+
+    // a forward range is counted first, and the buckets are grown once for all its elements
+    template<typename InputIterator, typename = mystl::RequireInputIterator<InputIterator>>
+    void insert( InputIterator first, InputIterator last )
+    {
+        set_.reserve_range( first, last, typename std::iterator_traits<InputIterator>::iterator_category() );
+        while( first != last )
+        {
+            insert( *(first++) );
+        }
+    }
+
+    void insert( std::initializer_list<value_type> lst )
+    {
+        insert( lst.begin(), lst.end() );
+    }
+
+    // the entry is constructed first to get its key, and destroyed if the key exists
+    template<typename... Args>
+    std::pair<iterator, bool> emplace( Args&&... args )
+    {
+        auto result = set_.insert( entry( construct_tag(), std::forward<Args>( args )... ) );
+        return { iterator( result.first ), result.second };
+    }
+
+    /**
+       if the key doesn't exist, inserts a value constructed from key and args,
+       otherwise does nothing, args are not moved from in that case
+    **/
+    template <typename... Args>
+    std::pair<iterator, bool> try_emplace( const key_type &key, Args&&... args )
+    {
+        return emplace_key( key, std::forward<Args>( args )... );
+    }
+
+    template <typename... Args>
+    std::pair<iterator, bool> try_emplace( key_type &&key, Args&&... args )
+    {
+        return emplace_key( std::move( key ), std::forward<Args>( args )... );
+    }
+
+    // assigns obj to the mapped value of key, or inserts it if the key doesn't exist
+    template <typename M>
+    std::pair<iterator, bool> insert_or_assign( const key_type &key, M &&obj )
+    {
+        auto result = emplace_key( key, std::forward<M>( obj ) );
+        if( !result.second )
+        {
+            result.first->second = std::forward<M>( obj );
+        }
+        return result;
+    }
+
+    template <typename M>
+    std::pair<iterator, bool> insert_or_assign( key_type &&key, M &&obj )
+    {
+        auto result = emplace_key( std::move( key ), std::forward<M>( obj ) );
+        if( !result.second )
+        {
+            result.first->second = std::forward<M>( obj );
+        }
+        return result;
+    }
+
+    // returns the mapped value of key, a value-initialized one is inserted if the key doesn't exist
+    mapped_type &operator[]( const key_type &key )
+    {
+        return emplace_key( key ).first->second;
+    }
+
+    mapped_type &operator[]( key_type &&key )
+    {
+        return emplace_key( std::move( key ) ).first->second;
+    }
+
+    // throw std::out_of_range if the key doesn't exist
+    mapped_type &at( const key_type &key )
+    {
+        auto iter = find( key );
+        if( iter == end() )
+        {
+            throw std::out_of_range( "unordered_map::at() - the specify key doesn't exist" );
+        }
+        return iter->second;
+    }
+
+    const mapped_type &at( const key_type &key ) const
+    {
+        return const_cast<unordered_map *>( this )->at( key );
+    }
+
+    iterator find( const key_type &key )
+    {
+        return iterator( set_.find_with( set_.hash_( key ), key ) );
+    }
+
+    const_iterator find( const key_type &key ) const
+    {
+        return const_cast<unordered_map *>( this )->find( key );
+    }
+
+    /**
+       looks up a key of another type, such as a const char * in a map of std::string,
+       without constructing a key_type. hasher and key_equal must both declare is_transparent
+    **/
+    template <typename K, typename H = Hash, typename E = Equal,
+              typename = typename H::is_transparent, typename = typename E::is_transparent>
+    iterator find( const K &key )
+    {
+        return iterator( set_.find_with( set_.hash_( key ), key ) );
+    }
+
+    template <typename K, typename H = Hash, typename E = Equal,
+              typename = typename H::is_transparent, typename = typename E::is_transparent>
+    const_iterator find( const K &key ) const
+    {
+        return const_cast<unordered_map *>( this )->find( key );
+    }
+
+    size_type count( const key_type &key ) const
+    {
+        return find( key ) == end() ? 0 : 1;
+    }
+
+    template <typename K, typename H = Hash, typename E = Equal,
+              typename = typename H::is_transparent, typename = typename E::is_transparent>
+    size_type count( const K &key ) const
+    {
+        return find( key ) == end() ? 0 : 1;
+    }
+
+    iterator erase( const_iterator position )
+    {
+        if( position == cend() )
+        {
+            throw unordered_set_exception( "unordered_map::erase(): the specify iterator is an off-the-end iterator!" );
+        }
+        return iterator( set_.erase( position.iter_ ) );
+    }
+
+    iterator erase( const_iterator first, const_iterator last )
+    {
+        while( first != last )
+        {
+            first = erase( first );
+        }
+        return iterator( last.iter_ );
+    }
+
+    size_type erase( const key_type &key )
+    {
+        set_.migrate_buckets( set_type::REHASH_STEP );
+        auto iter = find( key );
+        if( iter == end() )
+        {
+            return 0;
+        }
+        erase( iter );
+        return 1;
+    }
+
+    // an iterator is never taken for a key
+    template <typename K, typename H = Hash, typename E = Equal,
+              typename = typename H::is_transparent, typename = typename E::is_transparent,
+              typename = typename std::enable_if<!std::is_convertible<K, const_iterator>::value>::type>
+    size_type erase( const K &key )
+    {
+        set_.migrate_buckets( set_type::REHASH_STEP );
+        auto iter = find( key );
+        if( iter == end() )
+        {
+            return 0;
+        }
+        erase( iter );
+        return 1;
+    }
+
+    bool operator==( const unordered_map &other ) const
+    {
+        if( size() != other.size() )
+        {
+            return false;
+        }
+        for( const auto &elem : *this )
+        {
+            auto iter = other.find( elem.first );
+            if( iter == other.end() || !( iter->second == elem.second ) )
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool operator!=( const unordered_map &other ) const
+    {
+        return !( *this == other );
+    }
+
+private:
+    // a single lookup, then the entry is constructed in place if the key doesn't exist
+    template <typename K, typename... Args>
+    std::pair<iterator, bool> emplace_key( K &&key, Args&&... args )
+    {
+        const size_type hash = set_.hash_( key );
+        auto iter = set_.find_with( hash, key );
+        if( iter != set_.end() )
+        {
+            return { iterator( iter ), false };
+        }
+        iter = set_.insert_new( hash, construct_tag(), std::piecewise_construct,
+                                std::forward_as_tuple( std::forward<K>( key ) ),
+                                std::forward_as_tuple( std::forward<Args>( args )... ) );
+        return { iterator( iter ), true };
+    }
+};
+
+template <typename Key, typename T, typename Hash, typename Equal, typename BucketPolicy>
+inline void swap( unordered_map<Key, T, Hash, Equal, BucketPolicy> &left, 
+                  unordered_map<Key, T, Hash, Equal, BucketPolicy> &right ) noexcept
+{
+    left.swap( right );
+}
+
+};    // namespace mystl
+
+
+
+#endif /* _UNORDERED_MAP_H_ */
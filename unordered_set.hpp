@@ -12,15 +12,32 @@
 
 #include <utility>
 #include <cstddef>
+#include <cstdint>
 #include "vector.hpp"
 #include "forward_list.hpp"
 #include "algorithm.hpp"
 #include "iterator.hpp"
+#include "hash_policy.hpp"
 #include <initializer_list>        
 #include <iostream>
+#include <array>
+#include <chrono>
+#include <algorithm>
+#include <string>
+#include <type_traits>
+#include <thread>
+#include <memory>
+#include <exception>
+#include <cmath>
 
 namespace mystl {
 
+template <typename Key, typename T, typename Hash, typename Equal, typename BucketPolicy>
+class unordered_map;
+
+template <typename T, typename Hash, typename Equal>
+class concurrent_unordered_set;
+
 class unordered_set_exception : public std::exception
 {
 public:
@@ -38,12 +55,226 @@ private:
     std::string message_;
 };
 
-template <typename T, typename Hash = std::hash<T>, typename Equal = std::equal_to<T>>
+/**
+   whether the buckets of unordered_set store the hash code with each element, 
+   it's on for strings, which are expensive to hash and to compare.
+   specialize it for other types, or pass CacheHash to unordered_set explicitly
+**/
+template <typename T>
+struct cache_hash_code : std::false_type
+{
+};
+
+template <typename Char, typename Traits, typename Allocator>
+struct cache_hash_code<std::basic_string<Char, Traits, Allocator>> : std::true_type
+{
+};
+
+/**
+   an element in the buckets of unordered_set. with a cached hash code, rehash() doesn't hash 
+   the elements again, and lookups only call Equal on the elements with the same hash code
+**/
+template <typename T, bool CacheHash>
+struct hash_node
+{
+    hash_node() = default;
+
+    template <typename... Args>
+    explicit hash_node( std::size_t hash, Args&&... args )
+        : value_( std::forward<Args>( args )... ), hash_( hash )
+    {
+    }
+
+    template <typename Hash>
+    std::size_t hash_code( const Hash & ) const noexcept
+    {
+        return hash_;
+    }
+
+    // returns false if the element can't be equal to a key with the hash code
+    bool may_equal( std::size_t hash ) const noexcept
+    {
+        return hash_ == hash;
+    }
+
+    T value_;
+    std::size_t hash_ = 0;
+};
+
+template <typename T>
+struct hash_node<T, false>
+{
+    hash_node() = default;
+
+    template <typename... Args>
+    explicit hash_node( std::size_t, Args&&... args )
+        : value_( std::forward<Args>( args )... )
+    {
+    }
+
+    template <typename Hash>
+    std::size_t hash_code( const Hash &hash ) const
+    {
+        return hash( value_ );
+    }
+
+    bool may_equal( std::size_t ) const noexcept
+    {
+        return true;
+    }
+
+    T value_;
+};
+
+/**
+   one bit for each bucket of unordered_set, set if the bucket is not empty.
+   iterating the set skips 64 empty buckets with one word, instead of loading every bucket
+**/
+class bucket_bitmap
+{
+public:
+    // bucket_num buckets, all empty
+    void reset( std::size_t bucket_num )
+    {
+        words_.clear();
+        words_.resize( ( bucket_num + WORD_BITS - 1 ) / WORD_BITS );
+    }
+
+    void clear() noexcept
+    {
+        std::fill( words_.begin(), words_.end(), word_type( 0 ) );
+    }
+
+    void set( std::size_t index ) noexcept
+    {
+        words_.begin()[index / WORD_BITS] |= word_type( 1 ) << ( index % WORD_BITS );
+    }
+
+    void unset( std::size_t index ) noexcept
+    {
+        words_.begin()[index / WORD_BITS] &= ~( word_type( 1 ) << ( index % WORD_BITS ) );
+    }
+
+    // returns the first set bit not before index, or bucket_num if there is none
+    std::size_t find_next( std::size_t index, std::size_t bucket_num ) const noexcept
+    {
+        if( index >= bucket_num ) 
+        {
+            return bucket_num;
+        }
+        const word_type *words = words_.begin();
+        std::size_t i = index / WORD_BITS;
+        word_type word = words[i] & ( ~word_type( 0 ) << ( index % WORD_BITS ) );
+        const std::size_t last = ( bucket_num - 1 ) / WORD_BITS;
+        while( word == 0 ) 
+        {
+            if( ++i > last ) 
+            {
+                return bucket_num;
+            }
+            word = words[i];
+        }
+        return i * WORD_BITS + count_trailing_zeros( word );
+    }
+
+    std::size_t bytes() const noexcept
+    {
+        return words_.capacity() * sizeof( word_type );
+    }
+
+    void swap( bucket_bitmap &other ) noexcept
+    {
+        words_.swap( other.words_ );
+    }
+
+private:
+    using word_type = std::uint64_t;
+
+    static const std::size_t WORD_BITS = 64;
+
+    static std::size_t count_trailing_zeros( word_type word ) noexcept
+    {
+#if defined( __GNUC__ )
+        return static_cast<std::size_t>( __builtin_ctzll( word ) );
+#else
+        std::size_t n = 0;
+        for( ; ( word & 1 ) == 0; word >>= 1 ) 
+        {
+            ++n;
+        }
+        return n;
+#endif
+    }
+
+    mystl::vector<word_type> words_;
+};
+
+/**
+   passed to the bulk insert() and the constructors of unordered_set to promise that the elements 
+   are distinct, so they are linked into the buckets without looking for duplicates
+**/
+struct unique_keys_t
+{
+};
+
+constexpr unique_keys_t unique_keys{};
+
+/**
+   the shape of an unordered_set, returned by unordered_set::stats().
+   long chains or many empty buckets at a normal load factor point to a poor hash function
+**/
+struct hash_table_stats
+{
+    static const std::size_t HISTOGRAM_SIZE = 8;
+
+    std::size_t  size = 0;
+    std::size_t  bucket_count = 0;          // during an incremental rehash, the buckets of both tables
+    std::size_t  empty_buckets = 0;
+    std::size_t  max_chain = 0;             // elements in the longest bucket
+    double       average_probe = 0;         // elements compared by a successful lookup on average
+
+    // chain_histogram[i] is the number of buckets with i elements, the last one also counts the longer chains
+    std::array<std::size_t, HISTOGRAM_SIZE> chain_histogram = {{}};
+
+    // the buckets and the nodes, not the memory the elements own nor the overhead of the allocator
+    std::size_t  bytes_used = 0;
+
+    // rehashes since the container was created, an incremental rehash counts once
+    std::size_t               rehash_count = 0;
+    std::chrono::nanoseconds  rehash_time{ 0 };
+
+    double empty_bucket_ratio() const noexcept
+    {
+        return bucket_count == 0 ? 0 : static_cast<double>( empty_buckets ) / bucket_count;
+    }
+
+    double bytes_per_element() const noexcept
+    {
+        return size == 0 ? 0 : static_cast<double>( bytes_used ) / size;
+    }
+};
+
+/**
+   BucketPolicy picks the bucket count and the bucket of a hash code, see hash_policy.hpp. 
+   the default prime_bucket_policy suits weak hash functions, power_of_two_bucket_policy avoids the division
+**/
+template <typename T, typename Hash = std::hash<T>, typename Equal = std::equal_to<T>, 
+          bool CacheHash = cache_hash_code<T>::value, typename BucketPolicy = prime_bucket_policy>
 class unordered_set
 {
+    // unordered_map keeps its entries in an unordered_set, and looks them up by key
+    template <typename, typename, typename, typename, typename>
+    friend class unordered_map;
+
+    // concurrent_unordered_set hashes outside its locks, and passes the hash codes in
+    template <typename, typename, typename>
+    friend class concurrent_unordered_set;
+
 private:
-    using bucket_type           = mystl::forward_list<T>;
+    using node_type             = hash_node<T, CacheHash>;
+    using bucket_type           = mystl::forward_list<node_type>;
     using bucket_vector         = mystl::vector<bucket_type>;
+    using node_iterator         = typename bucket_type::const_iterator;
     
 public:
     using key_type              = T;
@@ -57,12 +288,66 @@ public:
     using size_type             = std::size_t;
     using difference_type       = std::ptrdiff_t;
 
+    // iterates the elements of a bucket
+    class const_local_iterator
+    {
+        friend class unordered_set;
+    public:
+        using value_type        = T;
+        using pointer           = const T*;
+        using reference         = const T&;
+        using difference_type   = std::ptrdiff_t;
+        using iterator_category = std::forward_iterator_tag;
+
+        const_local_iterator() = default;
+
+        reference operator*() const
+        {
+            return iter_->value_;
+        }
+
+        pointer operator->() const
+        {
+            return &( operator*() );
+        }
+
+        const_local_iterator &operator++() noexcept
+        {
+            ++iter_;
+            return *this;
+        }
+
+        const_local_iterator operator++(int) noexcept
+        {
+            auto tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        bool operator==( const const_local_iterator &other ) const noexcept
+        {
+            return iter_ == other.iter_;
+        }
+
+        bool operator!=( const const_local_iterator &other ) const noexcept
+        {
+            return !( *this == other );
+        }
+
+    private:
+        explicit const_local_iterator( node_iterator iter )
+            : iter_( iter )
+        {
+        }
+
+        node_iterator iter_;
+    };
+
     /*
-      both local_iterator and const_local_iterator are forward_list's const_iterator
+      both local_iterator and const_local_iterator are constant iterators
       because we don't want user modify element by using iterator 
      */
-    using local_iterator        = typename mystl::forward_list<value_type>::const_iterator;
-    using const_local_iterator  = typename mystl::forward_list<value_type>::const_iterator;
+    using local_iterator        = const_local_iterator;
 
     class const_iterator
     {
@@ -75,13 +360,13 @@ public:
         using iterator_category = std::forward_iterator_tag;
         
         const_iterator() 
-            : ptr_( nullptr ), index_( 0 )
+            : set_( nullptr ), old_( false ), index_( 0 )
         {  
         }
 
         reference operator*() const
         { 
-            return *iter_;
+            return iter_->value_;
         }
 
         pointer operator->() const 
@@ -91,10 +376,9 @@ public:
         
         const_iterator &operator++() noexcept   
         {
-            ++iter_;
-            while( iter_ == (*ptr_)[index_].cend() && ++index_ < ptr_->size() ) 
+            if( ++iter_ == set_->table( old_ )[index_].cend() ) 
             {
-                iter_ = (*ptr_)[index_].cbegin();
+                seek( index_ + 1 );
             }
             return *this;
         }
@@ -108,7 +392,7 @@ public:
         
         bool operator==( const const_iterator &other ) const noexcept 
         {
-            return ptr_ == other.ptr_ && index_ == other.index_ && iter_ == other.iter_;
+            return old_ == other.old_ && index_ == other.index_ && iter_ == other.iter_;
         }
         
         bool operator!=( const const_iterator &other ) const noexcept 
@@ -117,33 +401,58 @@ public:
         }
 
     protected:
-        const_iterator( bucket_vector *ptr, bool end )
-            : ptr_( ptr ) 
+        /**
+           during an incremental rehash the iteration walks the old table, then the new one,
+           end() is past the last bucket of the new table
+        **/
+        const_iterator( const unordered_set *set, bool end )
+            : set_( set ), old_( false ), index_( 0 )
         {
             if( end ) 
             {
-                index_ = ptr_->size();
+                index_ = set_->buckets_.size();
             } 
             else 
             {
-                index_ = 0;
-                iter_ = (*ptr_)[index_].cbegin();
-                while( iter_ == (*ptr_)[index_].cend() && ++index_ < ptr_->size() ) 
-                {
-                    iter_ = (*ptr_)[index_].cbegin();
-                }
+                old_ = set_->rehash_in_progress();
+                seek( 0 );
             }
         }
         
-        const_iterator( bucket_vector *ptr, size_type index, local_iterator iter ) 
-            : ptr_( ptr ), index_( index ), iter_( iter )
+        const_iterator( const unordered_set *set, bool old, size_type index, node_iterator iter ) 
+            : set_( set ), old_( old ), index_( index ), iter_( iter )
         {
         }
 
     private:
-        const bucket_vector *ptr_;
+        // moves to the first element of the first non-empty bucket from bucket index
+        void seek( size_type index ) noexcept
+        {
+            for( ; ; ) 
+            {
+                const auto &buckets = set_->table( old_ );
+                index = set_->occupancy( old_ ).find_next( index, buckets.size() );
+                if( index < buckets.size() ) 
+                {
+                    index_ = index;
+                    iter_ = buckets[index].cbegin();
+                    return;
+                }
+                if( !old_ ) 
+                {
+                    index_ = buckets.size();
+                    iter_ = node_iterator();
+                    return;
+                }
+                old_ = false;
+                index = 0;
+            }
+        }
+
+        const unordered_set *set_;
+        bool old_;                  // in the old table of an incremental rehash
         size_type index_;
-        local_iterator iter_;
+        node_iterator iter_;
     };
 
     /**
@@ -156,34 +465,52 @@ private:
     hasher         hash_;                           // hash function
     key_equal      equal_;                          // for test value' equality
     bucket_vector  buckets_;                        // a vector contains all buckets
+    bucket_bitmap  occupied_;                       // the non-empty buckets of buckets_
     size_type      size_ = 0;                       // elements number
     float          max_load_factor_ = 1.0;          // max load factor
 
-    static const size_type PRIME_SIZE = 28;
-    static const size_type prime_[PRIME_SIZE];
-    
-    size_type next_prime( size_type n ) const 
+    // during an incremental rehash, the buckets of old_buckets_ are moved to buckets_ a few at a time
+    bucket_vector  old_buckets_;                    // empty if there is no incremental rehash in progress
+    bucket_bitmap  old_occupied_;                   // the non-empty buckets of old_buckets_
+    size_type      rehash_index_ = 0;               // the buckets of old_buckets_ before it are empty
+    bool           incremental_rehash_ = false;
+
+    // for stats(), not copied with the elements
+    size_type                  rehash_count_ = 0;
+    std::chrono::nanoseconds   rehash_time_{ 0 };
+
+    // number of old buckets moved by each insert() and erase()
+    static const size_type REHASH_STEP = 8;
+
+    // number of keys find_batch() hashes and prefetches ahead of probing
+    static const size_type BATCH_SIZE = 32;
+
+    // parallel_insert() starts another thread for every PARALLEL_GRAIN elements at most
+    static const size_type PARALLEL_GRAIN = 4096;
+
+    static size_type next_bucket_count( size_type n ) noexcept 
     {
-        auto first = std::begin( prime_ );
-        auto last = std::end( prime_ );
+        return BucketPolicy::next_bucket_count( n );
+    }
 
-        auto iter = std::lower_bound( first, last,  n );
-        return iter == last ? *( last - 1 ) : *iter;
+    static size_type bucket_index( size_type hash, size_type bucket_count ) noexcept 
+    {
+        return BucketPolicy::bucket_index( hash, bucket_count );
     }
 
 public:
     unordered_set() 
     {
-        const size_type num = next_prime( 0 );
-        buckets_.reserve( num );
-        buckets_.insert( buckets_.cend(), num, bucket_type() );
+        buckets_.resize( next_bucket_count( 0 ) );
+        occupied_.reset( buckets_.size() );
     }
     
     explicit unordered_set( size_type bucket_num, const hasher &hash = hasher(), const key_equal &equal = key_equal() )
         : hash_( hash ), 
           equal_( equal ), 
-          buckets_( next_prime( bucket_num ), bucket_type() )
+          buckets_( make_buckets( next_bucket_count( bucket_num ) ) )
     {  
+        occupied_.reset( buckets_.size() );
     }    
 
     template<typename InputIterator, typename = mystl::RequireInputIterator<InputIterator>>
@@ -191,11 +518,24 @@ public:
                    const hasher &hash = hasher(), const key_equal &equal = key_equal() ) 
         : hash_( hash ), 
           equal_( equal ),
-          buckets_( next_prime( bucket_num ), bucket_type() )
+          buckets_( make_buckets( next_bucket_count( bucket_num ) ) )
     {
+        occupied_.reset( buckets_.size() );
         insert( first, last );
     }
 
+    // the elements of [first, last) must be distinct, see insert( unique_keys_t, first, last )
+    template<typename InputIterator, typename = mystl::RequireInputIterator<InputIterator>>
+    unordered_set( unique_keys_t, InputIterator first, InputIterator last, size_type bucket_num = 0, 
+                   const hasher &hash = hasher(), const key_equal &equal = key_equal() ) 
+        : hash_( hash ), 
+          equal_( equal ),
+          buckets_( make_buckets( next_bucket_count( bucket_num ) ) )
+    {
+        occupied_.reset( buckets_.size() );
+        insert( unique_keys, first, last );
+    }
+
     unordered_set( std::initializer_list<value_type> lst, size_type bucket_num = 0,
                    const hasher &hash = hasher(), const key_equal &equal = key_equal() )
         : unordered_set( lst.begin(), lst.end(), bucket_num, hash, equal ) 
@@ -203,10 +543,17 @@ public:
     }    
     
     unordered_set( const unordered_set &other )
+        : hash_( other.hash_ ),
+          equal_( other.equal_ ),
+          buckets_( other.buckets_ ),
+          occupied_( other.occupied_ ),
+          size_( other.size_ ),
+          max_load_factor_( other.max_load_factor_ ),
+          old_buckets_( other.old_buckets_ ),
+          old_occupied_( other.old_occupied_ ),
+          rehash_index_( other.rehash_index_ ),
+          incremental_rehash_( other.incremental_rehash_ )
     {
-        buckets_ = other.bucket_;
-        size_ = other.size_;
-        max_load_factor_ = other.max_load_factor_;
     }
 
     unordered_set( unordered_set &&other ) noexcept 
@@ -219,7 +566,7 @@ public:
     unordered_set &operator=( const unordered_set &other ) 
     {
         auto copy = other;
-        swap( other );
+        swap( copy );
         return *this;
     }
 
@@ -244,9 +591,18 @@ public:
     void swap( unordered_set &other ) noexcept
     {
         using std::swap;
+        swap( hash_, other.hash_ );
+        swap( equal_, other.equal_ );
         swap( buckets_, other.buckets_ );
+        occupied_.swap( other.occupied_ );
         swap( size_, other.size_ );
         swap( max_load_factor_, other.max_load_factor_ );
+        swap( old_buckets_, other.old_buckets_ );
+        old_occupied_.swap( other.old_occupied_ );
+        swap( rehash_index_, other.rehash_index_ );
+        swap( incremental_rehash_, other.incremental_rehash_ );
+        swap( rehash_count_, other.rehash_count_ );
+        swap( rehash_time_, other.rehash_time_ );
     }
 
     size_type bucket_count() const noexcept 
@@ -260,23 +616,65 @@ public:
     **/
     void rehash( size_type size_hint ) 
     {
+        complete_rehash();
         if( size_hint <= bucket_count() ) 
         {
             return;
         }
-        const size_type new_bucket_count = next_prime( size_hint );
+        const size_type new_bucket_count = next_bucket_count( size_hint );
 
         if( new_bucket_count > bucket_count() ) 
         {
-            unordered_set other( new_bucket_count );
-            for( auto &elem : *this ) 
+            const auto start = std::chrono::steady_clock::now();
+            auto buckets = make_buckets( new_bucket_count );
+            bucket_bitmap occupied;
+            occupied.reset( new_bucket_count );
+            for( auto &bucket : buckets_ ) 
             {
-                other.insert( std::move( elem ) );
+                relink_bucket( bucket, buckets, occupied );
             }
-            swap( other );
+            buckets_.swap( buckets );
+            occupied_.swap( occupied );
+            ++rehash_count_;
+            rehash_time_ += std::chrono::steady_clock::now() - start;
         }
     }
 
+    /**
+       in the incremental rehash mode, when insert() finds the load factor too high, it doesn't 
+       rehash all elements at once. instead it allocates the new buckets, then each insert() and erase() 
+       moves a few buckets of the old table to the new one, lookups search both tables meanwhile.
+       this bounds the latency of every insert(), at the cost of slightly slower lookups during the rehash.
+
+       while the rehash is in progress, the bucket interface only covers the new table
+       and inserting or erasing a value may move any element, like a rehash does
+    **/
+    void incremental_rehash( bool enable ) 
+    {
+        if( !enable ) 
+        {
+            complete_rehash();
+        }
+        incremental_rehash_ = enable;
+    }
+
+    bool incremental_rehash() const noexcept 
+    {
+        return incremental_rehash_;
+    }
+
+    // returns true if some elements are still in the old table of an incremental rehash
+    bool rehash_in_progress() const noexcept 
+    {
+        return !old_buckets_.empty();
+    }
+
+    // moves all remaining elements of an incremental rehash to the new table
+    void complete_rehash() 
+    {
+        migrate_buckets( old_buckets_.size() );
+    }
+
     float load_factor() const noexcept
     {
         return static_cast<float>( size() ) / static_cast<float>( bucket_count() );
@@ -290,9 +688,17 @@ public:
         }
     }
     
+    // destroys all elements, the buckets are kept
     void clear() noexcept 
     {
-        buckets_.clear();
+        for( auto &bucket : buckets_ ) 
+        {
+            bucket.clear();
+        }
+        occupied_.clear();
+        bucket_vector().swap( old_buckets_ );
+        bucket_bitmap().swap( old_occupied_ );
+        rehash_index_ = 0;
         size_ = 0;
     }
 
@@ -308,13 +714,13 @@ public:
 
     size_type max_size() const noexcept 
     {
-        return prime_[PRIME_SIZE - 1];
+        return BucketPolicy::max_bucket_count();
     }
 
     // this is the maximum potential number of buckets the container can have 
     size_type max_bucket_count() const noexcept 
     {
-        return prime_[PRIME_SIZE - 1];
+        return BucketPolicy::max_bucket_count();
     }
     
     float max_load_factor() const noexcept 
@@ -336,7 +742,7 @@ public:
     {
         if( elem_num > static_cast<size_type>( bucket_count() * max_load_factor() ) ) 
         {
-            rehash( bucket_count() + 1 );
+            rehash( static_cast<size_type>( std::ceil( elem_num / max_load_factor() ) ) );
         }
     }
     
@@ -345,51 +751,80 @@ public:
     ***/
     size_type bucket( const value_type &value ) const 
     {
-        return hash_( value ) % bucket_count();
+        return bucket_index( hash_( value ), bucket_count() );
     }
 
     std::pair<iterator, bool> insert( const value_type &value ) 
     {
-        auto copy = value;
-        return insert( std::move( copy ) );
+        const size_type hash = hash_( value );
+        auto iter = find_with( hash, value );
+        if( iter != end() ) 
+        {
+            return { iter, false };
+        }
+        return { insert_new( hash, value ), true };
     }
 
     std::pair<iterator, bool> insert( value_type &&value ) 
     {
-        // if current load factor greater than max load factor
-        // then we need to rehash the container 
-        if( load_factor() > max_load_factor() ) 
-        {
-            rehash( bucket_count() + 1 );         // force rehash
-        }
-
-        // compute the bucket index for that value
-        const size_type pos = bucket( value );
-        
-        auto iter = mystl::find( cbegin( pos ), cend( pos ), value );
+        const size_type hash = hash_( value );
+        auto iter = find_with( hash, value );
 
         // if container doesn't contains the specify value, then we insert it
         // otherwise we don't
-        if( iter == cend( pos ) ) 
-        {
-            buckets_[pos].push_front( std::move( value ) );
-            ++size_;
-            return { iterator{ &buckets_, pos, begin( pos ) }, true };
-        } 
-        else 
+        if( iter != end() ) 
         {
-            return { iterator{ &buckets_, pos, begin( pos ) }, false };
+            return { iter, false };
         }
+        return { insert_new( hash, std::move( value ) ), true };
     }
 
+    // a forward range is counted first, and the buckets are grown once for all its elements
     template<typename InputIterator, typename = mystl::RequireInputIterator<InputIterator>>
     void insert( InputIterator first, InputIterator last ) 
 	{
+        reserve_range( first, last, typename std::iterator_traits<InputIterator>::iterator_category() );
         while( first != last ) 
         {
             insert( *(first++) );
         }
     }
+
+    /**
+       inserts the elements of [first, last) without looking for duplicates, so each element costs 
+       one hash and one allocation. the caller must make sure the elements are distinct 
+       and none of them is in the container, otherwise the container holds duplicates
+    **/
+    template<typename InputIterator, typename = mystl::RequireInputIterator<InputIterator>>
+    void insert( unique_keys_t, InputIterator first, InputIterator last ) 
+    {
+        reserve_range( first, last, typename std::iterator_traits<InputIterator>::iterator_category() );
+        for( ; first != last; ++first ) 
+        {
+            insert_new( hash_( *first ), *first );
+        }
+    }
+
+    /**
+       inserts the elements of [first, last) with thread_num threads, 0 means one for each hardware thread.
+       the buckets are grown once, the elements are hashed in parallel, then each thread links 
+       the elements of its own range of buckets, so no two threads touch the same bucket.
+
+       Hash, Equal and the constructor of T are called from several threads at once.
+       if one of them throws, the elements linked so far stay in the container and the exception is rethrown
+    **/
+    template<typename RandomIterator, typename = mystl::RequireRandomIterator<RandomIterator>>
+    void parallel_insert( RandomIterator first, RandomIterator last, size_type thread_num = 0 ) 
+    {
+        parallel_build( first, last, thread_num, false );
+    }
+
+    // like parallel_insert( first, last, thread_num ), the elements must be distinct and not in the container
+    template<typename RandomIterator, typename = mystl::RequireRandomIterator<RandomIterator>>
+    void parallel_insert( unique_keys_t, RandomIterator first, RandomIterator last, size_type thread_num = 0 ) 
+    {
+        parallel_build( first, last, thread_num, true );
+    }
     
     void insert( std::initializer_list<value_type> lst ) 
     {
@@ -399,37 +834,12 @@ public:
     template<typename... Args> 
     std::pair<iterator, bool> emplace( Args&&... args ) 
     {
-        // if current load factor greater than max load factor
-        // then we need to rehash the container 
-        if( load_factor() > max_load_factor() ) 
-        {
-            rehash( bucket_count() + 1 );         // force rehash
-        }
-
-        value_type value( std::forward<Args>( args )... );
-
-        // compute the bucket index for that value
-        const size_type pos = bucket( value );
-        
-        auto iter = mystl::find( begin( pos ), end( pos ), value );
-        
-        // if container doesn't contains the specify value, then we insert it
-        // otherwise we don't
-        if( iter == buckets_[pos].cend() ) 
-        {
-            buckets_[pos].push_front( std::move( value ) );
-            ++size_;
-            return { iterator{ &buckets_, pos, begin( pos ) }, true };
-        } 
-        else 
-        {
-            return { iterator{ &buckets_, pos, begin( pos ) }, false };
-        }
+        return insert( value_type( std::forward<Args>( args )... ) );
     }
 
     iterator begin() noexcept 
     {
-        return { &buckets_, false };
+        return { this, false };
     }
 
     const_iterator begin() const noexcept 
@@ -439,7 +849,7 @@ public:
 
     iterator end() noexcept 
     {
-        return { &buckets_, true };
+        return { this, true };
     }
 
     const_iterator end() const noexcept 
@@ -459,42 +869,42 @@ public:
 
     local_iterator begin( size_type bucket_index ) 
     {
-        return buckets_[bucket_index].begin();
+        return const_local_iterator( buckets_[bucket_index].cbegin() );
     }
     
     const_local_iterator begin( size_type bucket_index ) const 
     {
-        return buckets_[bucket_index].begin();
+        return const_local_iterator( buckets_[bucket_index].cbegin() );
     }
     
     local_iterator end( size_type bucket_index ) 
     {
-        return buckets_[bucket_index].end();
+        return const_local_iterator( buckets_[bucket_index].cend() );
     }
 
     const_local_iterator end( size_type bucket_index ) const 
     {
-        return buckets_[bucket_index].end();
+        return const_local_iterator( buckets_[bucket_index].cend() );
     }
     
     const_local_iterator cbegin( size_type bucket_index ) const 
     {
-        return buckets_[bucket_index].cbegin();
+        return const_local_iterator( buckets_[bucket_index].cbegin() );
     }
     
     const_local_iterator cend( size_type bucket_index ) const 
     {
-        return buckets_[bucket_index].cend();
+        return const_local_iterator( buckets_[bucket_index].cend() );
     }
 
     hasher hash_function() const 
     {
-        return hasher();
+        return hash_;
     }
     
     key_equal key_eq() const 
     {
-        return key_equal();
+        return equal_;
     }
     
     // returns the number of elements in the specify bucket
@@ -503,14 +913,42 @@ public:
         return buckets_[bucket_index].size();
     }
 
+    // walks every bucket, so it costs O( bucket_count() ) but doesn't touch the elements
+    hash_table_stats stats() const 
+    {
+        hash_table_stats result;
+        result.size = size();
+        result.rehash_count = rehash_count_;
+        result.rehash_time = rehash_time_;
+
+        size_type probes = 0;
+        for( const auto *buckets : { &buckets_, &old_buckets_ } ) 
+        {
+            for( const auto &bucket : *buckets ) 
+            {
+                const size_type length = bucket.size();
+                ++result.chain_histogram[std::min( length, hash_table_stats::HISTOGRAM_SIZE - 1 )];
+                result.max_chain = std::max( result.max_chain, length );
+                result.empty_buckets += length == 0 ? 1 : 0;
+                probes += length * ( length + 1 ) / 2;
+            }
+            result.bucket_count += buckets->size();
+            result.bytes_used += buckets->capacity() * sizeof( bucket_type );
+        }
+        result.bytes_used += occupied_.bytes() + old_occupied_.bytes();
+        result.average_probe = size() == 0 ? 0 : static_cast<double>( probes ) / size();
+
+        // every bucket has a dummy node, and every node holds a pointer to the next one
+        result.bytes_used += sizeof( *this ) + ( result.bucket_count + size() ) * ( sizeof( node_type ) + sizeof( void * ) );
+        return result;
+    }
+
     /***
         returns 1 if an element with that value exists in the container, and zero otherwise.
     ***/
     size_type count( const value_type &value ) const 
     {
-        const size_type pos = bucket( value );
-        auto iter = mystl::find( cbegin( pos ), cend( pos ), value );
-        return iter == cend( pos ) ? 0 : 1;
+        return find( value ) == cend() ? 0 : 1;
     }
 
     const_iterator find( const value_type &value ) const 
@@ -524,16 +962,59 @@ public:
     ***/
     iterator find( const value_type &value ) 
     {
-        size_type pos = bucket( value );
-        auto iter = mystl::find( cbegin( pos ), cend( pos ), value );
-        if( iter == cend( pos ) ) 
-        {
-            return end();
-        } 
-        else 
-        {
-            return { &buckets_, pos, iter };
-        }
+        return find_with( hash_( value ), value );
+    }
+
+    /**
+       the lookups below accept a key of another type, such as a const char * or a string_view 
+       in a set of std::string, without constructing a value_type. 
+       hasher and key_equal must both declare is_transparent, and hash the key as they hash value_type
+    **/
+    template <typename K, typename H = Hash, typename E = Equal,
+              typename = typename H::is_transparent, typename = typename E::is_transparent>
+    iterator find( const K &key ) 
+    {
+        return find_with( hash_( key ), key );
+    }
+
+    template <typename K, typename H = Hash, typename E = Equal,
+              typename = typename H::is_transparent, typename = typename E::is_transparent>
+    const_iterator find( const K &key ) const 
+    {
+        return const_cast<unordered_set *>( this )->find( key );
+    }
+
+    template <typename K, typename H = Hash, typename E = Equal,
+              typename = typename H::is_transparent, typename = typename E::is_transparent>
+    size_type count( const K &key ) const 
+    {
+        return find( key ) == cend() ? 0 : 1;
+    }
+
+    /**
+       looks up every key in range [first, last), and writes the results to result in the same order, 
+       returns the end of the results. the keys are looked up BATCH_SIZE at a time: all of them are hashed 
+       and their buckets are prefetched before the first probe, so the cache misses of different keys overlap 
+       instead of happening one after another. this pays off when the set is much larger than the cache
+    **/
+    template <typename ForwardIterator, typename OutputIterator>
+    OutputIterator find_batch( ForwardIterator first, ForwardIterator last, OutputIterator result ) const 
+    {
+        lookup_batch( first, last, [&result]( const_iterator iter ) {
+            *result++ = iter;
+        } );
+        return result;
+    }
+
+    // same as find_batch(), but writes whether each key exists
+    template <typename ForwardIterator, typename OutputIterator>
+    OutputIterator contains_batch( ForwardIterator first, ForwardIterator last, OutputIterator result ) const 
+    {
+        const auto last_elem = cend();
+        lookup_batch( first, last, [&result, &last_elem]( const_iterator iter ) {
+            *result++ = ( iter != last_elem );
+        } );
+        return result;
     }
 
     /**
@@ -545,9 +1026,23 @@ public:
         {
             throw unordered_set_exception( "unordered_set::erase(): the specify iterator is an off-the-end iterator!" );
         }
-        size_type pos = position.index_;
-        buckets_[pos].remove( *position );
-        return ++position;
+        auto next = position;
+        ++next;
+
+        // position is in either buckets_ or old_buckets_
+        auto &bucket = ( position.old_ ? old_buckets_ : buckets_ )[position.index_];
+        auto previous = bucket.cbefore_begin();
+        for( auto iter = bucket.cbegin(); iter != position.iter_; ++iter ) 
+        {
+            ++previous;
+        }
+        bucket.erase_after( previous );
+        if( bucket.empty() ) 
+        {
+            ( position.old_ ? old_occupied_ : occupied_ ).unset( position.index_ );
+        }
+        --size_;
+        return next;
     }
     
     /**
@@ -556,17 +1051,30 @@ public:
     **/
     size_type erase( const value_type &value ) 
     {
-        size_type pos = bucket( value );
-        auto iter = mystl::find( cbegin( pos ), cend( pos ) );
-        if( iter == cend( pos ) ) 
+        migrate_buckets( REHASH_STEP );
+        auto iter = find( value );
+        if( iter == end() ) 
         {
             return 0;
         } 
-        else 
+        erase( iter );
+        return 1;
+    }
+
+    // an iterator is never taken for a key
+    template <typename K, typename H = Hash, typename E = Equal,
+              typename = typename H::is_transparent, typename = typename E::is_transparent,
+              typename = typename std::enable_if<!std::is_convertible<K, const_iterator>::value>::type>
+    size_type erase( const K &key ) 
+    {
+        migrate_buckets( REHASH_STEP );
+        auto iter = find( key );
+        if( iter == end() ) 
         {
-            buckets_[pos].remove( value );   
-            return 1;
-        }
+            return 0;
+        } 
+        erase( iter );
+        return 1;
     }
 
     /**
@@ -575,13 +1083,9 @@ public:
      **/
     iterator erase( const_iterator first, const_iterator last ) 
     {
-        if( first == last ) 
-        {
-            return last;
-        }
-        for( auto iter = first; iter != last; ++iter ) 
+        while( first != last ) 
         {
-            erase( iter );
+            first = erase( first );
         }
         return last;
     }
@@ -605,28 +1109,412 @@ public:
     {
         return !(*this == other);
     }
-};
 
-// prime number serve as bucket count
-template <typename T, typename Hash, typename Equal>
-const typename unordered_set<T, Hash, Equal>::size_type 
-unordered_set<T, Hash, Equal>::prime_[PRIME_SIZE] = 
-{
-    53u, 97u, 193u, 389u, 769u, 1543u, 3079u, 6151u, 12289u, 24593u, 49157u, 
-    98317u, 196613u, 393241u, 786433u, 1572869u, 3145739u, 6291469u, 12582917u, 
-    25165843u, 50331653u, 100663319u, 201326611u, 402653189u, 805306457u, 
-    1610612741u, 3221225473u, 4294967291u,
+private:
+    /**
+       searches the bucket of hash for an element which equals to key, 
+       Key may be another type than value_type if equal_ accepts it
+    **/
+    template <typename Key>
+    iterator find_with( size_type hash, const Key &key ) 
+    {
+        if( bucket_count() == 0 ) 
+        {
+            return end();
+        }
+        const size_type pos = bucket_index( hash, bucket_count() );
+        const auto &bucket = buckets_[pos];
+        for( auto iter = bucket.cbegin(); iter != bucket.cend(); ++iter ) 
+        {
+            if( iter->may_equal( hash ) && equal_( iter->value_, key ) ) 
+            {
+                return { this, false, pos, iter };
+            }
+        }
+        
+        if( rehash_in_progress() ) 
+        {
+            const size_type old_pos = bucket_index( hash, old_buckets_.size() );
+            const auto &bucket = old_buckets_[old_pos];
+            for( auto iter = bucket.cbegin(); iter != bucket.cend(); ++iter ) 
+            {
+                if( iter->may_equal( hash ) && equal_( iter->value_, key ) ) 
+                {
+                    return { this, true, old_pos, iter };
+                }
+            }
+        }
+        return end();
+    }
+
+    template <typename ForwardIterator, typename Visitor>
+    void lookup_batch( ForwardIterator first, ForwardIterator last, Visitor visit ) const 
+    {
+        size_type hashes[BATCH_SIZE];
+        size_type positions[BATCH_SIZE];
+        node_iterator heads[BATCH_SIZE];
+        
+        while( first != last ) 
+        {
+            if( bucket_count() == 0 ) 
+            {
+                visit( cend() );
+                ++first;
+                continue;
+            }
+
+            // hashes the keys, and prefetches their buckets
+            size_type n = 0;
+            for( auto iter = first; iter != last && n < BATCH_SIZE; ++iter, ++n ) 
+            {
+                hashes[n] = hash_( *iter );
+                positions[n] = bucket_index( hashes[n], bucket_count() );
+                prefetch( &buckets_[positions[n]] );
+            }
+
+            // a bucket reaches its first node through its dummy node, which is prefetched first
+            for( size_type i = 0; i < n; ++i ) 
+            {
+                const auto &bucket = buckets_[positions[i]];
+                if( !bucket.empty() ) 
+                {
+                    prefetch( &*bucket.cbefore_begin() );
+                }
+            }
+            for( size_type i = 0; i < n; ++i ) 
+            {
+                const auto &bucket = buckets_[positions[i]];
+                heads[i] = bucket.cbegin();
+                if( !bucket.empty() ) 
+                {
+                    prefetch( &*heads[i] );
+                }
+            }
+
+            for( size_type i = 0; i < n; ++i, ++first ) 
+            {
+                visit( probe( hashes[i], positions[i], heads[i], *first ) );
+            }
+        }
+    }
+
+    // searches the bucket at pos from iter, then the old table if an incremental rehash is in progress
+    template <typename Key>
+    const_iterator probe( size_type hash, size_type pos, node_iterator iter, const Key &key ) const 
+    {
+        for( const auto last = buckets_[pos].cend(); iter != last; ++iter ) 
+        {
+            if( iter->may_equal( hash ) && equal_( iter->value_, key ) ) 
+            {
+                return { this, false, pos, iter };
+            }
+        }
+        return rehash_in_progress() ? const_cast<unordered_set *>( this )->find_with( hash, key ) : cend();
+    }
+
+    template <typename InputIterator>
+    void reserve_range( InputIterator, InputIterator, std::input_iterator_tag ) 
+    {
+    }
+
+    template <typename ForwardIterator>
+    void reserve_range( ForwardIterator first, ForwardIterator last, std::forward_iterator_tag ) 
+    {
+        reserve( size() + static_cast<size_type>( std::distance( first, last ) ) );
+    }
+
+    /**
+       the buckets are split into one partition for each thread, and every partition starts 
+       at a multiple of 64 buckets, so two threads never write to the same word of occupied_.
+       the elements are bucket sorted by partition, then each thread links the elements of its partition
+       in their order in the range, so the first of equal elements is the one kept
+    **/
+    template <typename RandomIterator>
+    void parallel_build( RandomIterator first, RandomIterator last, size_type thread_num, bool unique ) 
+    {
+        const size_type elem_num = static_cast<size_type>( last - first );
+        complete_rehash();
+        reserve( size() + elem_num );
+
+        if( thread_num == 0 ) 
+        {
+            thread_num = std::thread::hardware_concurrency();
+        }
+        thread_num = std::max<size_type>( 1, std::min( thread_num, elem_num / PARALLEL_GRAIN ) );
+
+        const size_type buckets_num = bucket_count();
+        const size_type width = ( ( buckets_num + 63 ) / 64 + thread_num - 1 ) / thread_num * 64;
+
+        mystl::vector<size_type> hash_codes;
+        mystl::vector<size_type> order;
+        mystl::vector<size_type> counts;
+        hash_codes.resize_default_init( elem_num );
+        order.resize_default_init( elem_num );
+        counts.resize( thread_num * thread_num + 1 );
+
+        size_type *hashes = hash_codes.begin();
+        size_type *positions = order.begin();
+        size_type *offsets = counts.begin();            // offsets[part * thread_num + chunk]
+
+        // every thread hashes a chunk of the range, and counts the elements of the chunk in each partition
+        run_parallel( thread_num, [&]( size_type chunk ) 
+        {
+            for( size_type i = elem_num * chunk / thread_num; i < elem_num * ( chunk + 1 ) / thread_num; ++i ) 
+            {
+                hashes[i] = hash_( first[i] );
+                ++offsets[bucket_index( hashes[i], buckets_num ) / width * thread_num + chunk];
+            }
+        } );
+
+        size_type sum = 0;
+        for( size_type i = 0; i <= thread_num * thread_num; ++i ) 
+        {
+            const size_type count = offsets[i];
+            offsets[i] = sum;
+            sum += count;
+        }
+
+        // offsets[part * thread_num] is where the elements of the partition begin in order
+        mystl::vector<size_type> bounds;
+        bounds.resize( thread_num + 1 );
+        for( size_type part = 0; part <= thread_num; ++part ) 
+        {
+            bounds[part] = offsets[part * thread_num];
+        }
+
+        run_parallel( thread_num, [&]( size_type chunk ) 
+        {
+            for( size_type i = elem_num * chunk / thread_num; i < elem_num * ( chunk + 1 ) / thread_num; ++i ) 
+            {
+                positions[offsets[bucket_index( hashes[i], buckets_num ) / width * thread_num + chunk]++] = i;
+            }
+        } );
+
+        mystl::vector<size_type> inserted;
+        inserted.resize( thread_num );
+        size_type *linked = inserted.begin();
+        const size_type *starts = bounds.begin();
+        try 
+        {
+            run_parallel( thread_num, [&]( size_type part ) 
+            {
+                for( size_type k = starts[part]; k < starts[part + 1]; ++k ) 
+                {
+                    const size_type i = positions[k];
+                    const size_type pos = bucket_index( hashes[i], buckets_num );
+                    auto &bucket = buckets_[pos];
+                    if( !unique && contains_in( bucket, hashes[i], first[i] ) ) 
+                    {
+                        continue;
+                    }
+                    bucket.emplace_front( hashes[i], first[i] );
+                    occupied_.set( pos );
+                    ++linked[part];
+                }
+            } );
+        } 
+        catch( ... ) 
+        {
+            add_size( linked, thread_num );
+            throw;
+        }
+        add_size( linked, thread_num );
+    }
+
+    void add_size( const size_type *counts, size_type num ) noexcept 
+    {
+        for( size_type i = 0; i < num; ++i ) 
+        {
+            size_ += counts[i];
+        }
+    }
+
+    template <typename Key>
+    bool contains_in( const bucket_type &bucket, size_type hash, const Key &key ) const 
+    {
+        for( auto iter = bucket.cbegin(); iter != bucket.cend(); ++iter ) 
+        {
+            if( iter->may_equal( hash ) && equal_( iter->value_, key ) ) 
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+       calls func( 0 ) to func( thread_num - 1 ) on thread_num threads, the calling thread being one of them.
+       if a thread can't be started, its call runs on the calling thread. 
+       the first exception thrown by a call is rethrown after all threads finish
+    **/
+    template <typename Function>
+    static void run_parallel( size_type thread_num, Function func ) 
+    {
+        std::unique_ptr<std::exception_ptr[]> errors( new std::exception_ptr[thread_num] );
+        auto task = [&]( size_type index ) 
+        {
+            try 
+            {
+                func( index );
+            } 
+            catch( ... ) 
+            {
+                errors[index] = std::current_exception();
+            }
+        };
+
+        std::unique_ptr<std::thread[]> threads( new std::thread[thread_num] );
+        size_type started = 1;
+        try 
+        {
+            for( ; started < thread_num; ++started ) 
+            {
+                threads[started] = std::thread( task, started );
+            }
+        } 
+        catch( ... ) 
+        {
+        }
+        for( size_type index = started; index < thread_num; ++index ) 
+        {
+            task( index );
+        }
+        task( 0 );
+        for( size_type index = 1; index < started; ++index ) 
+        {
+            threads[index].join();
+        }
+
+        for( size_type index = 0; index < thread_num; ++index ) 
+        {
+            if( errors[index] ) 
+            {
+                std::rethrow_exception( errors[index] );
+            }
+        }
+    }
+
+    static void prefetch( const void *address ) noexcept 
+    {
+#if defined( __GNUC__ )
+        __builtin_prefetch( address );
+#else
+        (void)address;
+#endif
+    }
+
+    /**
+       inserts an element constructed from args into the bucket of hash, 
+       the caller must make sure the element is not in the container
+    **/
+    template <typename... Args>
+    iterator insert_new( size_type hash, Args&&... args ) 
+    {
+        migrate_buckets( REHASH_STEP );
+
+        // if current load factor greater than max load factor
+        // then we need to rehash the container 
+        if( bucket_count() == 0 || load_factor() > max_load_factor() ) 
+        {
+            if( incremental_rehash_ && bucket_count() != 0 ) 
+            {
+                start_incremental_rehash();
+            }
+            else 
+            {
+                rehash( bucket_count() + 1 );     // force rehash
+            }
+        }
+
+        const size_type pos = bucket_index( hash, bucket_count() );
+        buckets_[pos].emplace_front( hash, std::forward<Args>( args )... );
+        occupied_.set( pos );
+        ++size_;
+        return { this, false, pos, buckets_[pos].cbegin() };
+    }
+
+    // the current buckets become the old table, the new elements go to the new buckets
+    void start_incremental_rehash() 
+    {
+        complete_rehash();
+        const size_type new_bucket_count = next_bucket_count( bucket_count() + 1 );
+        if( new_bucket_count <= bucket_count() ) 
+        {
+            return;
+        }
+        const auto start = std::chrono::steady_clock::now();
+        auto buckets = make_buckets( new_bucket_count );
+        old_buckets_.swap( buckets_ );
+        buckets_.swap( buckets );
+        old_occupied_.swap( occupied_ );
+        occupied_.reset( new_bucket_count );
+        rehash_index_ = 0;
+        ++rehash_count_;
+        rehash_time_ += std::chrono::steady_clock::now() - start;
+    }
+
+    // the buckets are constructed in place, so T doesn't need to be copyable
+    static bucket_vector make_buckets( size_type bucket_num ) 
+    {
+        bucket_vector buckets;
+        buckets.resize( bucket_num );
+        return buckets;
+    }
+
+    // moves the nodes of bucket to their buckets in the new table, no element is copied or allocated
+    void relink_bucket( bucket_type &bucket, bucket_vector &buckets, bucket_bitmap &occupied ) 
+    {
+        while( !bucket.empty() ) 
+        {
+            const size_type pos = bucket_index( bucket.front().hash_code( hash_ ), buckets.size() );
+            auto &target = buckets[pos];
+            target.splice_after( target.cbefore_begin(), bucket, bucket.cbefore_begin() );
+            occupied.set( pos );
+        }
+    }
+
+    // moves the elements of at most n old buckets to the new table
+    void migrate_buckets( size_type n ) 
+    {
+        if( !rehash_in_progress() ) 
+        {
+            return;
+        }
+        const auto start = std::chrono::steady_clock::now();
+        for( ; n > 0 && rehash_index_ < old_buckets_.size(); --n, ++rehash_index_ ) 
+        {
+            relink_bucket( old_buckets_[rehash_index_], buckets_, occupied_ );
+            old_occupied_.unset( rehash_index_ );
+        }
+        rehash_time_ += std::chrono::steady_clock::now() - start;
+        if( rehash_index_ == old_buckets_.size() ) 
+        {
+            bucket_vector().swap( old_buckets_ );
+            bucket_bitmap().swap( old_occupied_ );
+            rehash_index_ = 0;
+        }
+    }
+
+    const bucket_vector &table( bool old ) const noexcept 
+    {
+        return old ? old_buckets_ : buckets_;
+    }
+
+    const bucket_bitmap &occupancy( bool old ) const noexcept 
+    {
+        return old ? old_occupied_ : occupied_;
+    }
 };
 
-template <typename T, typename Hash, typename Equal>
-inline std::ostream &operator<<( std::ostream &os, const unordered_set<T, Hash, Equal> &coll )
+template <typename T, typename Hash, typename Equal, bool CacheHash, typename BucketPolicy>
+inline std::ostream &operator<<( std::ostream &os, const unordered_set<T, Hash, Equal, CacheHash, BucketPolicy> &coll )
 {
     coll.print( os );
     return os;
 }
 
-template <typename T, typename Hash, typename Equal>
-inline void swap( unordered_set<T, Hash, Equal> &left, const unordered_set<T, Hash, Equal> &right ) noexcept 
+template <typename T, typename Hash, typename Equal, bool CacheHash, typename BucketPolicy>
+inline void swap( unordered_set<T, Hash, Equal, CacheHash, BucketPolicy> &left, unordered_set<T, Hash, Equal, CacheHash, BucketPolicy> &right ) noexcept 
 {
     left.swap( right );
 }
@@ -1,7 +1,7 @@
 /***
     vector
         1. 引入异常，对于不合法的操作会抛出异常
-        2. 使用 std::allocator 来管理内存
+        2. 使用 allocator 来管理内存，默认为 std::allocator，可通过 Allocator 模板参数替换
 
     版本 1.0
     作者：詹春畅
@@ -16,14 +16,113 @@
 #include "memory.hpp"
 #include <string>
 #include <iostream>
+#include <cstring>
+#include <limits>
+#include <algorithm>
 #include <exception>
+#include <stdexcept>
+#include <type_traits>
 #include <initializer_list> 
 
 namespace mystl { 
 
-template <typename T>
+/**
+   a growth policy decides the new capacity when vector runs out of room, it provides
+
+       static std::size_t next_capacity(std::size_t capacity, std::size_t required, std::size_t elem_size);
+
+   capacity is the current capacity, required is the minimal capacity needed now,
+   the result must be at least required
+**/
+
+/**
+   multiplies the capacity by Numerator / Denominator, an empty vector starts with FirstCapacity.
+   a factor below the golden ratio, e.g. 1.5, lets the allocator reuse the blocks freed by 
+   earlier expansions, a factor of 2 expands less often
+**/
+template <std::size_t Numerator, std::size_t Denominator, std::size_t FirstCapacity = 10>
+struct geometric_growth
+{
+    static_assert(Numerator > Denominator, "geometric_growth - the growth factor must be greater than 1");
+
+    static std::size_t next_capacity(std::size_t capacity, std::size_t required, std::size_t)
+    {
+        std::size_t new_capacity = FirstCapacity;
+        if (capacity != 0)
+        {
+            new_capacity = capacity / Denominator * Numerator + capacity % Denominator * Numerator / Denominator;
+            new_capacity = std::max(new_capacity, capacity + 1);
+        }
+        return std::max(new_capacity, required);
+    }
+};
+
+using double_growth         = geometric_growth<2, 1>;
+using one_and_a_half_growth = geometric_growth<3, 2>;
+
+/**
+   grows like BasePolicy, then rounds the size of the buffer up to the size class the
+   allocator would hand out anyway, the extra bytes become free capacity instead of slack:
+       1. up to 128 bytes, multiple of 16 bytes
+       2. up to PageSize bytes, four classes in every power of two ( 160, 192, 224, 256, 320 ... )
+       3. above PageSize bytes, multiple of PageSize
+   these are the size classes of jemalloc and tcmalloc, and never less than glibc gives
+**/
+template <typename BasePolicy = double_growth, std::size_t PageSize = 4096>
+struct size_class_growth
+{
+    static std::size_t next_capacity(std::size_t capacity, std::size_t required, std::size_t elem_size)
+    {
+        const std::size_t new_capacity = BasePolicy::next_capacity(capacity, required, elem_size);
+        if (new_capacity > std::numeric_limits<std::size_t>::max() / elem_size - PageSize)
+        {
+            return new_capacity;
+        }
+        return round_up_size_class(new_capacity * elem_size) / elem_size;
+    }
+
+    static std::size_t round_up_size_class(std::size_t bytes)
+    {
+        if (bytes <= 128)
+        {
+            return round_up(bytes, 16);
+        }
+        if (bytes <= PageSize)
+        {
+            // spacing of the four classes between 2^k and 2^(k+1) is 2^(k-2)
+            std::size_t power = 128;
+            while (power * 2 < bytes)
+            {
+                power *= 2;
+            }
+            return round_up(bytes, power / 4);
+        }
+        return round_up(bytes, PageSize);
+    }
+
+private:
+    static std::size_t round_up(std::size_t n, std::size_t alignment)
+    {
+        return (n + alignment - 1) / alignment * alignment;
+    }
+};
+
+/**
+   Allocator must follow std::allocator_traits, and its pointer type must be a raw T*
+   because vector's iterators are raw pointers
+**/
+template <typename T, typename Allocator = std::allocator<T>, typename GrowthPolicy = double_growth>
 class vector
 {
+    using alloc_traits             = std::allocator_traits<Allocator>;
+
+    // elements of such types are moved around with memcpy/memmove
+    using relocatable              = std::integral_constant<bool, mystl::is_trivially_relocatable<T>::value>;
+
+    // the buffer is grown by the allocator itself, e.g. by realloc() or mremap()
+    using grow_in_place            = std::integral_constant<bool, relocatable::value && 
+                                                                  mystl::allocator_can_reallocate<Allocator>::value>;
+
 public:
     using value_type               = T;
     using pointer                  = T*;
@@ -32,46 +131,59 @@ public:
     using const_reference          = const T&;
     using size_type                = std::size_t;
     using difference_type          = std::ptrdiff_t;
-    using allocator_type           = std::allocator<T>;
+    using allocator_type           = Allocator;
+    using growth_policy            = GrowthPolicy;
     using iterator                 = T*;
     using const_iterator           = const T*;
     using reverse_iterator         = std::reverse_iterator<T*>;
     using const_reverse_iterator   = std::reverse_iterator<const T*>;
 
-private:
-    static constexpr size_type FIRST_EXPAND_CAPACITY = 10;
-    static constexpr size_type EXPAND_RATE   = 2;
-    
+protected:
+    // derived containers such as small_vector adopt and hand over the storage directly
     pointer elem_ = nullptr;    // pointer to the first element in the allocated space
     pointer free_ = nullptr;    // pointer to the first free element in the allocated space
     pointer last_ = nullptr;    // pointer to one past the end of the allocated space
-    std::allocator<T> alloc_;   // allactor for allocate memory
+    allocator_type alloc_;      // allocator for allocate memory
+
+    static_assert(std::is_same<typename alloc_traits::value_type, value_type>::value,
+                  "vector - Allocator::value_type must be the same as T");
+    static_assert(std::is_same<typename alloc_traits::pointer, pointer>::value,
+                  "vector - Allocator::pointer must be a raw pointer");
 
 public:
     vector() noexcept = default;
 
-    explicit vector(size_type n)
+    explicit vector(const allocator_type &alloc) noexcept
+        : alloc_(alloc)
+    {
+    }
+
+    explicit vector(size_type n, const allocator_type &alloc = allocator_type())
+        : alloc_(alloc)
     {
         create_elements(n, value_type());
     }
 
-    vector(size_type n, const value_type &value)
+    vector(size_type n, const value_type &value, const allocator_type &alloc = allocator_type())
+        : alloc_(alloc)
     {
         create_elements(n, value);
     }
     
-    vector(std::initializer_list<value_type> values)
-        : vector(values.begin(), values.end())
+    vector(std::initializer_list<value_type> values, const allocator_type &alloc = allocator_type())
+        : vector(values.begin(), values.end(), alloc)
     {        
     }
     
     template<typename InputIterator, typename = mystl::RequireInputIterator<InputIterator>> 
-    vector(InputIterator first, InputIterator last)        
+    vector(InputIterator first, InputIterator last, const allocator_type &alloc = allocator_type())
+        : alloc_(alloc)
     {
         create_elements(first, last);
     }
 
     vector(const vector &other)
+        : alloc_(alloc_traits::select_on_container_copy_construction(other.alloc_))
     {
         create_elements(other.cbegin(), other.cend());
     }
@@ -87,6 +199,7 @@ public:
     }
 
     vector(vector &&other) noexcept
+        : alloc_(other.alloc_)
     {
         swap(other);
     }
@@ -205,9 +318,20 @@ public:
         return free_ - elem_;
     }
 
+    // new elements are value-initialized in place
     void resize(size_type new_size) 
     {
-        return resize(new_size, value_type());
+        if (new_size <= size()) 
+        {
+            erase(begin() + new_size, end());
+            return;
+        }
+        check_expand_capacity(new_size - size());
+        auto new_free = elem_ + new_size;
+        for (; free_ != new_free; ++free_)
+        {
+            alloc_traits::construct(alloc_, free_);
+        }
     }
 
     void resize(size_type new_size, const value_type &value) 
@@ -218,34 +342,102 @@ public:
         }
         else if (new_size > size()) 
         {
-            insert(end(), size() - new_size, value);
+            insert(end(), new_size - size(), value);
+        }
+    }
+
+    /**
+       like resize(), but new elements are default-initialized, 
+       so elements of trivial types keep whatever bytes the memory holds.
+       use it when the elements will be overwritten anyway, e.g. by read()
+    **/
+    void resize_default_init(size_type new_size)
+    {
+        if (new_size <= size()) 
+        {
+            erase(begin() + new_size, end());
+            return;
+        }
+        check_expand_capacity(new_size - size());
+        auto new_free = elem_ + new_size;
+        for (; free_ != new_free; ++free_)
+        {
+            ::new (static_cast<void *>(free_)) value_type;    // no parentheses, default-initialization
         }
     }
 
+    /**
+       same as resize_default_init(), but only for trivial types, 
+       and it never touches the memory of the new elements
+    **/
+    void resize_uninitialized(size_type new_size)
+    {
+        static_assert(std::is_trivial<value_type>::value, 
+                      "vector::resize_uninitialized() - value_type must be a trivial type");
+        if (new_size > size()) 
+        {
+            check_expand_capacity(new_size - size());
+        }
+        free_ = elem_ + new_size;
+    }
+
+    /**
+       makes room for n more elements and calls fill(first, n) with the uninitialized room,
+       fill constructs elements at the front of the room and returns how many it has constructed,
+       these elements are appended to the vector and their number is returned. 
+       e.g. vec.append(n, [fd](char *buf, std::size_t n) { return ::read(fd, buf, n); })
+
+       if fill returns a number greater than n ( a negative number included ), throw exception.
+       if fill throws, it must destroy the elements it has constructed
+    **/
+    template <typename FillFunction>
+    size_type append(size_type n, FillFunction fill)
+    {
+        check_expand_capacity(n);
+        auto written = fill(free_, n);
+        if (static_cast<size_type>(written) > n)
+        {
+            throw std::length_error("vector::append() - the fill function reports more elements than the room");
+        }
+        free_ += static_cast<size_type>(written);
+        return static_cast<size_type>(written);
+    }
+
     void push_back(const value_type &value) 
     {
         check_expand_capacity();
-        alloc_.construct(free_++, value);
+        alloc_traits::construct(alloc_, free_++, value);
     }
 
     void push_back(value_type &&value) 
     {
         check_expand_capacity();
-        new (free_) value_type(std::move(value)); // placement new
-        ++free_;
+        alloc_traits::construct(alloc_, free_++, std::move(value));
     }
 
     template<typename... Args> 
     void emplace_back(Args&&... args) 
     {
         check_expand_capacity();
-        alloc_.construct(free_++, std::forward<Args>(args)...);
+        alloc_traits::construct(alloc_, free_++, std::forward<Args>(args)...);
     }
 
+    /**
+       reallocates the storage to fit the elements exactly, 
+       elements are relocated rather than copied
+    **/
     void shrink_to_fit() 
     {
-        auto other = *this;
-        swap(other);
+        if (free_ == last_)
+        {
+            return;
+        }
+        if (empty())
+        {
+            clear_elements();
+            return;
+        }
+        reallocate_storage(size(), grow_in_place());
     }
 
     size_type capacity() const noexcept 
@@ -321,11 +513,11 @@ public:
 
     void pop_back() 
     {
-        if (!empty())
+        if (empty())
         {
-            alloc_.destroy(--free_);                        
+            throw std::length_error("vector::pop_back() - the vector is empty"); 
         }
-        throw std::length_error("vector::pop_back() - the vector is empty"); 
+        alloc_traits::destroy(alloc_, --free_);                        
     }
 
     template<typename... Args>
@@ -345,20 +537,11 @@ public:
 
         if (pos == cend())
         {
-            alloc_.construct(free_++, std::forward<Args>(args)...);
+            alloc_traits::construct(alloc_, free_++, std::forward<Args>(args)...);
             return free_ - 1;
         }
 
-        // move construct a new element
-        new (free_) value_type(std::move(*(free_ - 1))); 
-        ++free_;
-        
-        for (auto iter = free_ - 2; iter != pos; --iter)
-        {
-            *iter = std::move(*(iter - 1));
-        }
-        *pos = value_type(std::forward<Args>(args)...);
-        
+        emplace_middle(pos, relocatable(), std::forward<Args>(args)...);
         return pos;
     }
     
@@ -385,44 +568,41 @@ public:
     **/    
     iterator insert(const_iterator position, size_type n, const value_type &value) 
     {
+        if(position < cbegin() || position > cend()) 
+        {
+            throw std::out_of_range("vector::insert() - parameter \"position\" is out of bound");            
+        }
         auto pos = to_non_const(position);
 
         if(n == 0)
         {
             return pos;
         }
-        
-        // we must always update iterator because iterator may be in invalid state
-        for(size_type i = 0; i < n; ++i) 
-        {
-            pos = insert(pos, value);            
-        }        
-        return pos;
+        // value may refer to an element of this vector
+        auto copy = value;
+        return insert_range(pos, repeat_iterator(copy, 0), repeat_iterator(copy, n), n);
     }
 
     /**
        inserts a copy of all elements of the range [first, last) before the specify iterator 
        returns the position of the first new element 
-       or return the origin iterator if there is no new element ( n equals to zero )
+       or return the origin iterator if there is no new element ( n equals to zero ).
+       the tail after position is shifted only once, whatever the iterator category is
     **/
     template<typename InputIterator, typename = mystl::RequireInputIterator<InputIterator>>
     iterator insert(const_iterator position, InputIterator first, InputIterator last) 
     {
+        if(position < cbegin() || position > cend()) 
+        {
+            throw std::out_of_range("vector::insert() - parameter \"position\" is out of bound");            
+        }
         auto pos = to_non_const(position);
 
         if(first == last) 
         {
             return pos;
         }
-        // we must always update iterator pos because pos may be in invalid state
-        for(auto iter = first; iter != last; ++iter) 
-        {
-            pos = insert(pos, *iter);
-            ++pos;
-        }
-        pos -= std::distance(first, last);
-        
-        return pos;
+        return insert_range(pos, first, last, typename std::iterator_traits<InputIterator>::iterator_category());
     }
     
     /** 
@@ -436,14 +616,7 @@ public:
             throw std::out_of_range("vector::erase() - parameter \"position\" is out of bound");                        
         }        
         auto pos = to_non_const(position);
-        
-        if(position + 1 != cend()) 
-        {
-            std::move(position + 1, cend(), pos);
-        }
-        // destroy the last element
-        alloc_.destroy(--free_);
-        
+        erase_elements(pos, pos + 1, relocatable());
         return pos;
     }
 
@@ -453,19 +626,98 @@ public:
         {
             throw std::out_of_range("vector::erase() - parameter \"first\" or \"last\" is out of bound");            
         }
-        auto iter = std::move(to_non_const(last), free_, to_non_const(first));
-        destruct_elements(iter, free_);
-        
-        free_ = iter;
+        erase_elements(to_non_const(first), to_non_const(last), relocatable());
         return to_non_const(first);
     }
 
+    /**
+       removes all elements satisfying pred in a single pass, keeps the order of the others.
+       returns the number of elements erased
+    **/
+    template <typename Predicate>
+    size_type erase_if(Predicate pred)
+    {
+        auto new_free = std::remove_if(elem_, free_, pred);
+        const size_type n = free_ - new_free;
+        destruct_elements(new_free, free_);
+        free_ = new_free;
+        return n;
+    }
+
+    /**
+       removes the element at position by moving the last element into its place,
+       the order of elements is not kept, but nothing else has to move.
+       returns the position, which now holds the former last element
+    **/
+    iterator erase_unordered(const_iterator position)
+    {
+        if(position < cbegin() || position >= cend()) 
+        {
+            throw std::out_of_range("vector::erase_unordered() - parameter \"position\" is out of bound");                        
+        }
+        auto pos = to_non_const(position);
+        if (pos != free_ - 1)
+        {
+            *pos = std::move(*(free_ - 1));
+        }
+        alloc_traits::destroy(alloc_, --free_);
+        return pos;
+    }
+
+    /**
+       removes the elements at the indices in range [first, last), which must be sorted in ascending
+       order without duplicates, otherwise throw exception and the vector is left untouched.
+       if stable is true, the order of the remaining elements is kept and the vector is compacted
+       in one pass, otherwise every erased element is replaced by an element from the back.
+       either way the cost is linear instead of one tail shift per erased element
+    **/
+    template <typename BidirectionalIterator, typename = mystl::RequireBidirectionalIterator<BidirectionalIterator>>
+    void erase_indices(BidirectionalIterator first, BidirectionalIterator last, bool stable = true)
+    {
+        if (first == last)
+        {
+            return;
+        }
+        check_sorted_indices(first, last);
+
+        if (!stable)
+        {
+            // from the greatest index, so the last element is never one waiting to be erased
+            while (first != last)
+            {
+                erase_unordered(elem_ + *--last);
+            }
+            return;
+        }
+
+        // move every run of kept elements left over the holes before it
+        auto dest = elem_ + *first;
+        for (auto iter = first; iter != last; )
+        {
+            auto run_first = elem_ + *iter + 1;
+            auto run_last = ++iter == last ? free_ : elem_ + *iter;
+            dest = std::move(run_first, run_last, dest);
+        }
+        destruct_elements(dest, free_);
+        free_ = dest;
+    }
+
+    /**
+       allocators are always swapped together with the storage, so memory is 
+       always returned to the allocator which allocated it
+    **/
     void swap(vector &other) noexcept 
     {
         using std::swap;
         swap(elem_, other.elem_);
         swap(free_, other.free_);
         swap(last_, other.last_);
+        swap(alloc_, other.alloc_);
+    }
+
+    allocator_type get_allocator() const 
+    {
+        return alloc_;
     }
 
     void print(std::ostream &os = std::cout, const std::string &delim = " ") const 
@@ -488,12 +740,12 @@ public:
     }
 
 private:
-    void check_expand_capacity()
+    // make sure there is room for n more elements
+    void check_expand_capacity(size_type n = 1)
     {
-        if (free_ == last_)
+        if (static_cast<size_type>(last_ - free_) < n)
         {
-            size_type new_capacity = empty() ? FIRST_EXPAND_CAPACITY : size() * EXPAND_RATE;
-            expand_capacity(new_capacity);
+            expand_capacity(growth_policy::next_capacity(capacity(), size() + n, sizeof(value_type)));
         }
     }
     
@@ -503,45 +755,380 @@ private:
         {
             return;
         }
+        reallocate_storage(new_capacity, grow_in_place());
+    }
 
-        auto new_elem = alloc_.allocate(new_capacity);
-        auto new_free = new_elem;
+    /**
+       moves the elements into a buffer of new_capacity, new_capacity must not be less than size().
+       the allocator may extend the buffer without copying, and if it has to move the buffer
+       it moves the bytes, which is fine for trivially relocatable elements.
+       if the allocator throws, the origin buffer is left untouched
+    **/
+    void reallocate_storage(size_type new_capacity, std::true_type)
+    {
+        const size_type old_size = size();
+        auto new_elem = elem_ ? alloc_.reallocate(elem_, capacity(), new_capacity) 
+                              : alloc_traits::allocate(alloc_, new_capacity);
+        
+        elem_ = new_elem;
+        free_ = new_elem + old_size;
+        last_ = new_elem + new_capacity;
+    }
+
+    void reallocate_storage(size_type new_capacity, std::false_type)
+    {
+        auto new_elem = alloc_traits::allocate(alloc_, new_capacity);
+        pointer new_free;
+        try 
+        {
+            new_free = relocate_elements(elem_, free_, new_elem, relocatable());
+        }
+        catch(...)    // catch the exception throw by value_type's copy constructor
+        {    
+            alloc_traits::deallocate(alloc_, new_elem, new_capacity);
+            throw;
+        }
         
+        // the origin elements are already destroyed, only free the memory
+        if (elem_)
+        {
+            alloc_traits::deallocate(alloc_, elem_, capacity());
+        }
+        
+        elem_ = new_elem;
+        free_ = new_free;
+        last_ = new_elem + new_capacity;
+    }
+
+    /**
+       relocate elements in range [first, last) to the uninitialized memory dest, 
+       the source elements are destroyed, returns one past the last relocated element.
+       for trivially relocatable types this is a single memcpy
+    **/
+    pointer relocate_elements(pointer first, pointer last, pointer dest, std::true_type) noexcept
+    {
+        if (first != last)
+        {
+            std::memcpy(static_cast<void *>(dest), static_cast<const void *>(first), (last - first) * sizeof(value_type));
+        }
+        return dest + (last - first);
+    }
+
+    pointer relocate_elements(pointer first, pointer last, pointer dest, std::false_type)
+    {
+        auto new_free = dest;
+
         // if value_type's move constructor is noexcept, then move elements
         // otherwise copy elements
         if(std::is_nothrow_move_constructible<value_type>()) 
         {
-            for(auto iter = elem_; iter != free_; ++iter) 
+            for(auto iter = first; iter != last; ++iter) 
             {
-                new (new_free) value_type(std::move(*iter)); // placement new
+                alloc_traits::construct(alloc_, new_free, std::move(*iter));
                 ++new_free;
             }
         } 
         else 
         {
-            try 
+            // if value_type's copy constructor throws, the source is untouched
+            new_free = std::uninitialized_copy(first, last, dest);
+        }
+        destruct_elements(first, last);
+        return new_free;
+    }
+
+    // construct a new element at pos, pos must not be the end of the vector
+    template<typename... Args>
+    void emplace_middle(pointer pos, std::true_type, Args&&... args)
+    {
+        // build the element aside first, so nothing has been moved if the constructor throws
+        typename std::aligned_storage<sizeof(value_type), alignof(value_type)>::type buffer;
+        auto tmp = reinterpret_cast<pointer>(&buffer);
+        alloc_traits::construct(alloc_, tmp, std::forward<Args>(args)...);
+
+        std::memmove(static_cast<void *>(pos + 1), static_cast<const void *>(pos), (free_ - pos) * sizeof(value_type));
+        std::memcpy(static_cast<void *>(pos), static_cast<const void *>(tmp), sizeof(value_type));
+        ++free_;
+    }
+
+    template<typename... Args>
+    void emplace_middle(pointer pos, std::false_type, Args&&... args)
+    {
+        // move construct a new element
+        alloc_traits::construct(alloc_, free_, std::move(*(free_ - 1)));
+        ++free_;
+        
+        for (auto iter = free_ - 2; iter != pos; --iter)
+        {
+            *iter = std::move(*(iter - 1));
+        }
+        *pos = value_type(std::forward<Args>(args)...);
+    }
+
+    // a forward iterator which yields the same value again and again
+    class repeat_iterator
+    {
+    public:
+        using value_type        = T;
+        using pointer           = const T*;
+        using reference         = const T&;
+        using difference_type   = std::ptrdiff_t;
+        using iterator_category = std::forward_iterator_tag;
+
+        repeat_iterator(const T &value, size_type index) noexcept
+            : value_(&value), index_(index)
+        {
+        }
+
+        reference operator*() const noexcept
+        {
+            return *value_;
+        }
+
+        repeat_iterator &operator++() noexcept
+        {
+            ++index_;
+            return *this;
+        }
+
+        repeat_iterator operator++(int) noexcept
+        {
+            auto tmp = *this;
+            ++index_;
+            return tmp;
+        }
+
+        bool operator==(const repeat_iterator &other) const noexcept
+        {
+            return index_ == other.index_;
+        }
+
+        bool operator!=(const repeat_iterator &other) const noexcept
+        {
+            return index_ != other.index_;
+        }
+
+    private:
+        const T *value_;
+        size_type index_;
+    };
+
+    /**
+       the number of input elements is unknown, so append them all 
+       and then rotate them into place, this moves the tail only once
+    **/
+    template <typename InputIterator>
+    pointer insert_range(pointer pos, InputIterator first, InputIterator last, std::input_iterator_tag)
+    {
+        const difference_type diff = pos - elem_;
+        const size_type old_size = size();
+        try 
+        {
+            for (; first != last; ++first)
             {
-                new_free = std::uninitialized_copy(elem_, free_, new_elem);
+                emplace_back(*first);
             }
-            catch(...)    // catch the exception throw by value_type's copy constructor
-            {    
-                alloc_.deallocate(new_elem, new_capacity);
-                throw;
+        }
+        catch(...)
+        {
+            erase(elem_ + old_size, free_);
+            throw;
+        }
+        std::rotate(elem_ + diff, elem_ + old_size, free_);
+        return elem_ + diff;
+    }
+
+    template <typename ForwardIterator>
+    pointer insert_range(pointer pos, ForwardIterator first, ForwardIterator last, std::forward_iterator_tag)
+    {
+        return insert_range(pos, first, last, static_cast<size_type>(std::distance(first, last)));
+    }
+
+    // inserts the n elements of range [first, last) before pos, n must be greater than zero
+    template <typename ForwardIterator>
+    pointer insert_range(pointer pos, ForwardIterator first, ForwardIterator last, size_type n)
+    {
+        if (static_cast<size_type>(last_ - free_) < n)
+        {
+            return insert_range_grow(pos, first, last, n, grow_in_place());
+        }
+        return insert_range_in_place(pos, first, last, n, relocatable());
+    }
+
+    /**
+       the allocator grows the buffer itself, and may keep the same memory, e.g. mremap() of a file,
+       so a second buffer can't be allocated beside the live one. grow first, then shift the tail
+    **/
+    template <typename ForwardIterator>
+    pointer insert_range_grow(pointer pos, ForwardIterator first, ForwardIterator last, size_type n, std::true_type)
+    {
+        const difference_type diff = pos - elem_;
+        expand_capacity(growth_policy::next_capacity(capacity(), size() + n, sizeof(value_type)));
+        return insert_range_in_place(elem_ + diff, first, last, n, std::true_type());
+    }
+
+    template <typename ForwardIterator>
+    pointer insert_range_grow(pointer pos, ForwardIterator first, ForwardIterator last, size_type n, std::false_type)
+    {
+        return insert_range_reallocate(pos, first, last, n, relocatable());
+    }
+
+    // shift the tail only once, then copy into the hole
+    template <typename ForwardIterator>
+    pointer insert_range_in_place(pointer pos, ForwardIterator first, ForwardIterator last, size_type n, std::true_type)
+    {
+        const size_type tail = free_ - pos;
+        std::memmove(static_cast<void *>(pos + n), static_cast<const void *>(pos), tail * sizeof(value_type));
+        try 
+        {
+            std::uninitialized_copy(first, last, pos);
+        }
+        catch(...)     // catch the exception throw by value_type's copy constructor
+        {
+            std::memmove(static_cast<void *>(pos), static_cast<const void *>(pos + n), tail * sizeof(value_type));
+            throw;
+        }
+        free_ += n;
+        return pos;
+    }
+
+    template <typename ForwardIterator>
+    pointer insert_range_in_place(pointer pos, ForwardIterator first, ForwardIterator last, size_type n, std::false_type)
+    {
+        const size_type elems_after = free_ - pos;
+        auto old_free = free_;
+
+        if (elems_after > n)
+        {
+            // the last n elements move to the uninitialized memory, the rest shift inside the vector
+            for (auto iter = old_free - n; iter != old_free; ++iter)
+            {
+                alloc_traits::construct(alloc_, free_, std::move(*iter));
+                ++free_;
             }
+            std::move_backward(pos, old_free - n, old_free);
+            std::copy(first, last, pos);
         }
+        else
+        {
+            // part of the new elements and the whole tail go to the uninitialized memory
+            auto mid = first;
+            std::advance(mid, elems_after);
+            free_ = std::uninitialized_copy(mid, last, free_);
+            for (auto iter = pos; iter != old_free; ++iter)
+            {
+                alloc_traits::construct(alloc_, free_, std::move(*iter));
+                ++free_;
+            }
+            std::copy(first, mid, pos);
+        }
+        return pos;
+    }
+
+    /**
+       builds the new buffer as prefix, new elements, tail, so every element is relocated once.
+       new elements are constructed first, then nothing can throw
+    **/
+    template <typename ForwardIterator>
+    pointer insert_range_reallocate(pointer pos, ForwardIterator first, ForwardIterator last, size_type n, std::true_type)
+    {
+        const size_type new_capacity = growth_policy::next_capacity(capacity(), size() + n, sizeof(value_type));
+        auto new_elem = alloc_traits::allocate(alloc_, new_capacity);
+        auto new_pos = new_elem + (pos - elem_);
+        try 
+        {
+            std::uninitialized_copy(first, last, new_pos);
+        }
+        catch(...)     // catch the exception throw by value_type's copy constructor
+        {
+            alloc_traits::deallocate(alloc_, new_elem, new_capacity);
+            throw;
+        }
+        relocate_elements(elem_, pos, new_elem, std::true_type());
+        auto new_free = relocate_elements(pos, free_, new_pos + n, std::true_type());
+
+        if (elem_)
+        {
+            alloc_traits::deallocate(alloc_, elem_, capacity());
+        }
+        elem_ = new_elem;
+        free_ = new_free;
+        last_ = new_elem + new_capacity;
+        return new_pos;
+    }
+
+    // if the elements can only be copied, the vector is left untouched when a copy throws
+    template <typename ForwardIterator>
+    pointer insert_range_reallocate(pointer pos, ForwardIterator first, ForwardIterator last, size_type n, std::false_type)
+    {
+        const size_type new_capacity = growth_policy::next_capacity(capacity(), size() + n, sizeof(value_type));
+        auto new_elem = alloc_traits::allocate(alloc_, new_capacity);
+        auto new_pos = new_elem + (pos - elem_);
         
-        // remember to clear the origin vector's content
-        clear_elements();
+        // [constructed_first, constructed_last) are the elements constructed in the new buffer
+        auto constructed_first = new_pos;
+        auto constructed_last = new_pos;
+        try 
+        {
+            constructed_last = std::uninitialized_copy(first, last, new_pos);
+            uninitialized_move_if_noexcept(elem_, pos, new_elem);
+            constructed_first = new_elem;
+            constructed_last = uninitialized_move_if_noexcept(pos, free_, constructed_last);
+        }
+        catch(...)
+        {
+            destruct_elements(constructed_first, constructed_last);
+            alloc_traits::deallocate(alloc_, new_elem, new_capacity);
+            throw;
+        }
         
+        clear_elements();
         elem_ = new_elem;
-        free_ = new_free;
+        free_ = constructed_last;
         last_ = new_elem + new_capacity;
+        return new_pos;
+    }
+
+    /**
+       move elements if value_type's move constructor is noexcept, otherwise copy elements.
+       the source elements are not destroyed
+    **/
+    pointer uninitialized_move_if_noexcept(pointer first, pointer last, pointer dest)
+    {
+        if(std::is_nothrow_move_constructible<value_type>()) 
+        {
+            for(auto iter = first; iter != last; ++iter, ++dest) 
+            {
+                alloc_traits::construct(alloc_, dest, std::move(*iter));
+            }
+            return dest;
+        }
+        return std::uninitialized_copy(first, last, dest);
+    }
+
+    // removes elements in range [first, last)
+    void erase_elements(pointer first, pointer last, std::true_type) noexcept
+    {
+        if (first == last)
+        {
+            return;
+        }
+        destruct_elements(first, last);
+        std::memmove(static_cast<void *>(first), static_cast<const void *>(last), (free_ - last) * sizeof(value_type));
+        free_ -= last - first;
+    }
+
+    void erase_elements(pointer first, pointer last, std::false_type)
+    {
+        auto iter = std::move(last, free_, first);
+        destruct_elements(iter, free_);
+        free_ = iter;
     }
 
     // Note: before call this function, you must sure that the container is empty!
     void create_elements(size_type n, const value_type &value) 
     {
-        auto new_elem = alloc_.allocate(n);
+        auto new_elem = alloc_traits::allocate(alloc_, n);
 
         try 
         {
@@ -549,7 +1136,7 @@ private:
         }
         catch(...)     // catch the exception throw by value_type's copy constructor
         {
-            alloc_.deallocate(new_elem, n);    // avoid memory leak
+            alloc_traits::deallocate(alloc_, new_elem, n);    // avoid memory leak
             throw;
         }
         
@@ -567,7 +1154,7 @@ private:
         }
 
         auto n = std::distance(first, last);
-        auto new_elem = alloc_.allocate(n);
+        auto new_elem = alloc_traits::allocate(alloc_, n);
 
         pointer new_free;
         try 
@@ -576,7 +1163,7 @@ private:
         }
         catch(...)     // catch the exception throw by value_type's copy constructor
         {
-            alloc_.deallocate(new_elem, n);    // avoid memory leak
+            alloc_traits::deallocate(alloc_, new_elem, n);    // avoid memory leak
             throw;
         }
         
@@ -590,7 +1177,7 @@ private:
         if(elem_) 
         {
             destruct_elements(elem_, free_);
-            alloc_.deallocate(elem_, capacity());
+            alloc_traits::deallocate(alloc_, elem_, capacity());
             elem_ = free_ = last_ = nullptr;
         }
     }
@@ -601,7 +1188,29 @@ private:
         for (auto iter = first; iter != last; ++iter)
         {
             // assume value_type's destructor will not throw exception            
-            alloc_.destroy(iter);
+            alloc_traits::destroy(alloc_, iter);
+        }
+    }
+
+    // range [first, last) must not be empty
+    template <typename ForwardIterator>
+    void check_sorted_indices(ForwardIterator first, ForwardIterator last) const
+    {
+        if (static_cast<size_type>(*first) >= size())
+        {
+            throw std::out_of_range("vector::erase_indices() - index is out of bound");
+        }
+        auto prev = first;
+        for (++first; first != last; ++first, ++prev)
+        {
+            if (!(*prev < *first))
+            {
+                throw std::invalid_argument("vector::erase_indices() - indices must be sorted and unique");
+            }
+        }
+        if (static_cast<size_type>(*prev) >= size())
+        {
+            throw std::out_of_range("vector::erase_indices() - index is out of bound");
         }
     }
 
@@ -632,7 +1241,7 @@ public:
 
     bool operator<(const vector &other) const noexcept 
     {
-        return std::lexicographical_compare(cbegin(), cend(), other.cbegin(), other.cend());
+        return mystl::lexicographical_compare(cbegin(), cend(), other.cbegin(), other.cend());
     }
     
     bool operator>(const vector &other) const noexcept 
@@ -651,14 +1260,20 @@ public:
     }
 };
 
-template <typename T>
-void swap(vector<T> &first, vector<T> &second ) noexcept 
+// vector only holds three pointers and its allocator
+template <typename T, typename Allocator, typename GrowthPolicy>
+struct is_trivially_relocatable<vector<T, Allocator, GrowthPolicy>> : is_trivially_relocatable<Allocator>
+{
+};
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+void swap(vector<T, Allocator, GrowthPolicy> &first, vector<T, Allocator, GrowthPolicy> &second ) noexcept 
 {
     first.swap(second);
 }
     
-template <typename T>
-std::ostream &operator<<(std::ostream &os, const vector<T> &vec) 
+template <typename T, typename Allocator, typename GrowthPolicy>
+std::ostream &operator<<(std::ostream &os, const vector<T, Allocator, GrowthPolicy> &vec) 
 {
     vec.print(os, " ");
     return os;